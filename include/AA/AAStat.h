@@ -12,6 +12,7 @@
 
 #include "SVF-LLVM/BasicTypes.h"
 #include "SVFIR/SVFType.h"
+#include "CFLSolver/StatSink.h"
 #include <iostream>
 #include <map>
 #include <string>
@@ -34,9 +35,9 @@ public:
 
     /// num counters
     u32_t numOfIteration;
-    u32_t checks;
-    u32_t numOfSumEdges;
-    u32_t numOfSEdges;
+    u64_t checks;
+    u64_t numOfSumEdges;
+    u64_t numOfSEdges;
     u32_t numOfNodes;
     u32_t numOfEdges;
 
@@ -48,12 +49,23 @@ public:
     double gfTime;
     double interDyckTime;
     double gsTime;
+    double timeOfParsing;
+    double timeOfInit;
+    double timeOfCounting;
+    std::vector<double> roundTimes;     // wall time of each round of round-based solvers
+
+    /// A set for S edges, collected only for -write-spairs
+    std::map<NodeID, NodeBS> sEdgeSet;
 
 private:
     AliasAnalysis* aa;
 
     NUMStatMap PTNumStatMap;
     TIMEStatMap timeStatMap;
+    std::vector<std::string> roundTimeNames;    // keys of roundTimes in timeStatMap
+
+    /// Structured statistics (-stat-format)
+    StatSink sink;
 
     /// Memory usage, in KB
     u32_t _vmrssUsageBefore;
@@ -69,7 +81,14 @@ public:
                                numOfSumEdges(0),
                                numOfNodes(0),
                                numOfEdges(0),
-                               timeOfSolving(0)
+                               timeOfSolving(0),
+                               sccTime(0),
+                               gfTime(0),
+                               interDyckTime(0),
+                               gsTime(0),
+                               timeOfParsing(0),
+                               timeOfInit(0),
+                               timeOfCounting(0)
     {
         startClk();
     };
@@ -92,6 +111,10 @@ public:
     virtual void performStat();
     void pegStat();
     void printStat(std::string str = "");
+    /// Phases, peak memory and input identity after the printed stats, for the json and csv formats
+    void writeStructuredStat();
+    /// Self pairs are left out, as in the S pairs of CFLStat
+    void writeSPairsIntoFile(std::string fName);
 };
 }
 
@@ -16,6 +16,7 @@
 #include "PEGFold.h"
 #include "PEGInterDyck.h"
 #include "CFLData/ECG.h"
+#include "CFLSolver/QueryServer.h"
 
 namespace SVF
 {
@@ -78,6 +79,9 @@ public:
         delete interDyck;
     }
 
+    inline const std::string& getGraphName() const
+    { return graphName; }
+
     /// Graph operations
     //@{
     const inline PEG* graph() const
@@ -96,10 +100,25 @@ public:
     virtual void finalize();
     virtual bool pushIntoWorklist(NodeID src, NodeID dst, Label ty);
 
-    Set<Label> unarySumm(Label lty) override
+    /// Solved states (-save-state) for querying without solving, the kind is empty for solvers without states
+    //@{
+    virtual std::string getStateKind() const
+    { return ""; }
+
+    virtual void saveState(StateWriter& writer);
+    //@}
+
+    /// Queries (-serve) of the solvers with states, alias by V is the default symbol
+    //@{
+    static Map<CFGSymbTy, std::string> getWordNames();
+    virtual void setQueryData(QueryServer& server);
+    void serveQueries(const std::string& sockPath);
+    //@}
+
+    LabelSet unarySumm(Label lty) override
     { return {}; }
 
-    Set<Label> binarySumm(Label lty, Label rty) override
+    LabelSet binarySumm(Label lty, Label rty) override
     { return {}; }
 
     bool checkAndAddEdge(NodeID src, NodeID dst, Label lbl) override;
@@ -115,13 +134,10 @@ public:
     }
 
     virtual void countSumEdges();
-    //@}
 
-    static void timer()
-    {
-        sleep(CFLOpt::timeOut);
-        assert(false && "Time out!!");
-    }
+    u64_t getNumOfChecks() const override
+    { return stat->checks; }
+    //@}
 
     /// Graph simplifcation
     //@{
@@ -145,12 +161,15 @@ public:
     StdAA(std::string graphName) : AliasAnalysis(graphName)
     {}
 
+    std::string getStateKind() const override
+    { return "aa-std"; }
+
     void initSolver() override;
 
     /// CFLItem operations
     //@{
-    Set<Label> binarySumm(Label lty, Label rty) override;
-    Set<Label> unarySumm(Label lty) override;
+    LabelSet binarySumm(Label lty, Label rty) override;
+    LabelSet unarySumm(Label lty) override;
     //@}
 };
 
@@ -170,6 +189,12 @@ public:
     PocrAA(std::string gName) : AliasAnalysis(gName)
     {}
 
+    std::string getStateKind() const override
+    { return "aa-pocr"; }
+
+    void saveState(StateWriter& writer) override;
+    void setQueryData(QueryServer& server) override;
+
     void initSolver() override;
     void solve() override;
 
@@ -218,18 +243,20 @@ public:
 };
 
 /*!
- * Graspan (single thread for collecting derivation info)
+ * Graspan, rounds are solved in parallel with -threads=N
  */
 class GspanAA : public StdAA
 {
 protected:
     CFLData* _oldData;
+    u32_t numOfThreads;
 
 public:
     GspanAA(std::string gName) : StdAA(gName), _oldData(nullptr)
     {
         if (!_oldData)
-            _oldData = new CFLData();
+            _oldData = CFLData::createCFLData();
+        numOfThreads = getNumOfThreads(CFLOpt::threads());
     }
 
     CFLData* oldData()
@@ -237,14 +264,130 @@ public:
         return _oldData;
     }
 
+    std::string getStateKind() const override
+    { return ""; }
+
     void initSolver();
 
+    /// Visit the initial edges, i.e., the PEG edges with their reverse ones and the empty-rule edges of nodes
+    template<class F>
+    void forEachInitialEdge(F fn)
+    {
+        for (CFLEdge* edge: graph()->getPEGEdges())
+        {
+            if (edge->getEdgeKind() == PEG::Asgn)
+            {
+                fn(edge->getSrcID(), edge->getDstID(), std::make_pair(a, 0));
+                fn(edge->getDstID(), edge->getSrcID(), std::make_pair(abar, 0));
+            }
+            else if (edge->getEdgeKind() == PEG::Gep)
+            {
+                u32_t offset = edge->getEdgeIdx();
+                fn(edge->getSrcID(), edge->getDstID(), std::make_pair(f, offset));
+                fn(edge->getDstID(), edge->getSrcID(), std::make_pair(fbar, offset));
+            }
+            else if (edge->getEdgeKind() == PEG::Deref)
+            {
+                fn(edge->getSrcID(), edge->getDstID(), std::make_pair(d, 0));
+                fn(edge->getDstID(), edge->getSrcID(), std::make_pair(dbar, 0));
+            }
+        }
+
+        for (auto nIter = graph()->begin(); nIter != graph()->end(); ++nIter)
+        {
+            NodeID nodeId = nIter->first;
+            fn(nodeId, nodeId, std::make_pair(V, 0));
+            fn(nodeId, nodeId, std::make_pair(A, 0));
+            fn(nodeId, nodeId, std::make_pair(Abar, 0));
+        }
+    }
+
     virtual void solve();
 
+    /// One round, sources are summarized in parallel into thread-local results and then merged in parallel
+    void solveInParallel();
+    /// Edges derived from src by joining old and new edges
+    void summarize(NodeID src, CFLData::TypeMap& res, u64_t& checks);
+    /// Move new edges of src into old ones, and take the underived part of res as new edges
+    void update(NodeID src, CFLData::TypeMap& res);
+
     void countSumEdges();
 };
 
 
+/*!
+ * Out-of-core Graspan, nodes are split into intervals whose edges are kept in files under -part-dir,
+ * and two partitions are loaded and joined at a time until no partition changes.
+ */
+class PartGspanAA : public GspanAA
+{
+public:
+    /// A set of edges of (src, label) derived in the same session
+    struct Segment
+    {
+        NodeID src;
+        Label lbl;
+        u32_t stamp;
+        NodeBS dsts;
+    };
+    typedef std::vector<Segment> SegmentList;
+
+    /// Nodes in [lo, hi)
+    struct Partition
+    {
+        NodeID lo;
+        NodeID hi;
+        u64_t size;             // estimated bytes in memory
+        u32_t lastModified;     // session that last added edges
+    };
+
+protected:
+    std::string partDir;
+    u64_t budget;               // in bytes
+    std::vector<Partition> partitions;
+    std::map<NodeID, u32_t> partOfLo;
+    /// lastSession[p][q] is one plus the last session joining p and q,
+    /// edges stamped below it have already been joined with each other
+    std::vector<std::vector<u32_t>> lastSession;
+    u32_t numOfSessions;
+
+public:
+    PartGspanAA(std::string gName);
+
+    ~PartGspanAA() override;
+
+    void initSolver() override;
+
+    void solve() override;
+
+    void finalize() override;
+
+    void countSumEdges() override;
+
+protected:
+    /// Join partitions p and q until they reach a fixpoint
+    void runSession(u32_t p, u32_t q);
+    bool needSession(u32_t p, u32_t q) const;
+
+    /// Partition files
+    //@{
+    std::string partFileName(u32_t p) const;
+    void readPartition(u32_t p, SegmentList& segs) const;
+    void writePartition(u32_t p, SegmentList& segs);
+    /// Append segments of single edges, given as the words of their records, to be merged by writePartition
+    void appendPartition(u32_t p, const std::vector<u32_t>& records) const;
+    void removePartitions();
+    //@}
+
+    /// Split partitions exceeding the budget into two intervals
+    void splitPartition(u32_t p, SegmentList& segs);
+    u32_t partitionOf(NodeID node) const;
+    u32_t sessionOf(u32_t p, u32_t q) const;
+    void setSessionOf(u32_t p, u32_t q, u32_t session);
+    static u64_t estimateSize(const Segment& seg);
+};
+
+
 /*!
  * Standard CFL solver with rewritten grammar
  */
@@ -254,7 +397,10 @@ public:
     GRAA(std::string gName) : StdAA(gName)
     {};
 
-    Set<Label> binarySumm(Label lty, Label rty);
+    std::string getStateKind() const override
+    { return ""; }
+
+    LabelSet binarySumm(Label lty, Label rty);
 };
 
 
@@ -267,7 +413,7 @@ public:
     GRGspanAA(std::string gName) : GspanAA(gName)
     {}
 
-    Set<Label> binarySumm(Label lty, Label rty);
+    LabelSet binarySumm(Label lty, Label rty);
 };
 
 }
@@ -6,6 +6,7 @@
 #define POCR_SVF_CFLBASICUTILS_H
 
 #include <SVFIR/SVFType.h>
+#include <functional>
 
 namespace SVF
 {
@@ -14,10 +15,86 @@ typedef unsigned CFGSymbTy;
 typedef std::pair<CFGSymbTy, unsigned> Label;
 
 
+/*!
+ * Small set of labels returned by summarization.
+ * Labels are kept in an inline buffer, the heap is only touched when more than InlineSize labels are derived.
+ */
+class LabelSet
+{
+public:
+    static const u32_t InlineSize = 8;
+
+private:
+    Label inlineLbls[InlineSize];
+    std::vector<Label> moreLbls;
+    u32_t num;
+
+public:
+    LabelSet() : num(0)
+    {}
+
+    LabelSet(std::initializer_list<Label> lbls) : num(0)
+    {
+        for (const Label& lbl : lbls)
+            insert(lbl);
+    }
+
+    inline bool contains(const Label& lbl) const
+    {
+        for (const Label& it : *this)
+            if (it == lbl)
+                return true;
+        return false;
+    }
+
+    inline void insert(const Label& lbl)
+    {
+        if (contains(lbl))
+            return;
+
+        if (num < InlineSize)
+            inlineLbls[num] = lbl;
+        else
+        {
+            if (num == InlineSize)
+                moreLbls.assign(inlineLbls, inlineLbls + InlineSize);
+            moreLbls.push_back(lbl);
+        }
+        num++;
+    }
+
+    inline u32_t size() const
+    { return num; }
+
+    inline bool empty() const
+    { return num == 0; }
+
+    inline const Label* begin() const
+    { return num > InlineSize ? moreLbls.data() : inlineLbls; }
+
+    inline const Label* end() const
+    { return begin() + num; }
+};
+
+
+
+/// Exit status of the tools refusing the given options, told apart from errors (status 1) by bench and equiv
+const int UnsupportedExit = 2;
+
 /// basic methods for CFL-reachability
 void processArgs(int argc, char** argv, int& arg_num, char** arg_vec, std::vector<std::string>& inFileVec);
 //std::vector<std::string> split(std::string str, char s);
 std::string strip(std::string& str);
+/// Map a whole file read-only, false for missing or empty files
+bool mapFile(const std::string& fname, void*& base, size_t& length);
+
+/// The number of threads to use, 0 stands for all hardware threads
+u32_t getNumOfThreads(u32_t num);
+/// Run body(tid, idx) for every idx in [0, size) on numOfThreads threads, indices are handed out in chunks of grain
+void parallelFor(u32_t numOfThreads, u32_t size, const std::function<void(u32_t, u32_t)>& body, u32_t grain = 64);
+
+/// Non-empty items of str separated by sep
+std::vector<std::string> splitList(const std::string& str, char sep);
 
 }
 
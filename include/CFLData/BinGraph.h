@@ -0,0 +1,95 @@
+//
+// Binary graph files
+//
+
+#ifndef POCR_SVF_BINGRAPH_H
+#define POCR_SVF_BINGRAPH_H
+
+#include "BasicUtils.h"
+
+namespace SVF
+{
+/*!
+ * Compact binary form of the tab-separated graph files (src, dst, label[, idx]).
+ * A file consists of a header, a label dictionary and packed edge records sorted by source,
+ * and is mapped into memory for loading without any string handling.
+ * Text files are parsed into the same records, in file order.
+ */
+class BinGraph
+{
+public:
+    static const u32_t Version = 1;
+
+    struct Header
+    {
+        char magic[8];
+        u32_t version;
+        u32_t numOfLabels;
+        u64_t numOfEdges;
+        u64_t dictSize;     // bytes of the label dictionary, padded to records
+    };
+
+    /// lbl indexes the label dictionary, idx is 0 for labels without index
+    struct Record
+    {
+        NodeID src;
+        NodeID dst;
+        u32_t lbl;
+        u32_t idx;
+    };
+
+private:
+    void* base;
+    size_t length;
+    std::vector<std::string> labels;
+    const Record* records;
+    u64_t numOfEdges;
+    std::vector<Record> parsedRecords;      // records of a text file
+
+public:
+    BinGraph() : base(nullptr), length(0), records(nullptr), numOfEdges(0)
+    {}
+
+    ~BinGraph()
+    { close(); }
+
+    /// Map a binary graph file, false if it cannot be mapped or is not a binary graph
+    bool open(const std::string& fname);
+    /// Parse a text graph file, byte ranges split at line ends are parsed on numOfThreads threads.
+    /// False if it cannot be mapped, e.g., it is empty
+    bool parseText(const std::string& fname, u32_t numOfThreads);
+    /// Open a binary graph file or parse a text one
+    bool load(const std::string& fname, u32_t numOfThreads);
+    void close();
+
+    /// Whether a file starts with the binary graph magic
+    static bool isBinGraph(const std::string& fname);
+
+    /// Conversion between text and binary files
+    //@{
+    static bool convert(const std::string& textFName, const std::string& binFName);
+    static bool writeText(const std::string& binFName, const std::string& textFName);
+    //@}
+
+    /// Label dictionary and edges
+    //@{
+    inline u32_t getNumOfLabels() const
+    { return labels.size(); }
+
+    inline const std::string& getLabelString(u32_t lbl) const
+    { return labels[lbl]; }
+
+    inline u64_t getNumOfEdges() const
+    { return numOfEdges; }
+
+    inline const Record* begin() const
+    { return records; }
+
+    inline const Record* end() const
+    { return records + numOfEdges; }
+    //@}
+};
+
+}
+
+#endif //POCR_SVF_BINGRAPH_H
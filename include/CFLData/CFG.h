@@ -24,6 +24,42 @@ public:
         Count           // count non-terminals
     };
 
+    /// Where the subscript of a derived label comes from
+    enum IdxSrc
+    {
+        NoIdx,          // the derived label has no subscript
+        LeftIdx,        // taken from the (left) rhs label
+        RightIdx        // taken from the right rhs label
+    };
+
+    /*!
+     * A production rule compiled for summarization, with subscript handling decided ahead of time
+     */
+    struct CompiledRule
+    {
+        CFGSymbTy lhs;
+        IdxSrc idxSrc;
+        bool matchIdx;      // both rhs symbols are variant, so their subscripts must agree
+
+        inline Label derive(const Label& lty) const
+        { return Label(lhs, idxSrc == NoIdx ? 0 : lty.second); }
+
+        inline Label derive(const Label& lty, const Label& rty) const
+        { return Label(lhs, idxSrc == NoIdx ? 0 : (idxSrc == LeftIdx ? lty.second : rty.second)); }
+    };
+
+    struct RuleRange
+    {
+        const CompiledRule* b;
+        const CompiledRule* e;
+
+        inline const CompiledRule* begin() const
+        { return b; }
+
+        inline const CompiledRule* end() const
+        { return e; }
+    };
+
     LineTy lineTy;      // used to track the type of the current line
 
     /// number of symbols
@@ -46,9 +82,34 @@ public:
 
     const Set<CFGSymbTy> emptySet;
 
+private:
+    /// Compiled rules stored contiguously, indexed by rhs symbol (unary) or rhs symbol pair (binary)
+    //@{
+    u32_t numOfSlots;
+    std::vector<u32_t> unaryOffsets;
+    std::vector<CompiledRule> compiledUnaryRules;
+    std::vector<u32_t> binaryOffsets;
+    std::vector<CompiledRule> compiledBinaryRules;
+    //@}
+
+    /// Symbols combinable with a symbol through binary rules
+    //@{
+    std::vector<std::vector<CFGSymbTy>> rightSymbols;    // rightSymbols[Y] = {Z | X ::= Y Z}
+    std::vector<std::vector<CFGSymbTy>> leftSymbols;     // leftSymbols[Z] = {Y | X ::= Y Z}
+    const std::vector<CFGSymbTy> emptySymbols;
+    //@}
+
+    /// Rhs of the rules of a symbol
+    //@{
+    std::vector<std::vector<CFGSymbTy>> unaryRhs;                           // unaryRhs[X] = {Y | X ::= Y}
+    std::vector<std::vector<std::pair<CFGSymbTy, CFGSymbTy>>> binaryRhs;    // binaryRhs[X] = {(Y, Z) | X ::= Y Z}
+    const std::vector<std::pair<CFGSymbTy, CFGSymbTy>> emptySymbolPairs;
+    //@}
+
 public:
     CFG() : numOfSymbols(0),
-            lineTy(Production)
+            lineTy(Production),
+            numOfSlots(0)
     {}
 
     bool hasSymbol(std::string& s)
@@ -84,6 +145,41 @@ public:
         return it->second;
     }
 
+    /// Compiled rules X ::= rhs, valid after compileRules()
+    inline RuleRange getCompiledRules(CFGSymbTy rhs) const
+    {
+        if (rhs >= numOfSlots)
+            return {nullptr, nullptr};
+        const CompiledRule* base = compiledUnaryRules.data();
+        return {base + unaryOffsets[rhs], base + unaryOffsets[rhs + 1]};
+    }
+
+    /// Compiled rules X ::= lRhs rRhs, valid after compileRules()
+    inline RuleRange getCompiledRules(CFGSymbTy lRhs, CFGSymbTy rRhs) const
+    {
+        if (lRhs >= numOfSlots || rRhs >= numOfSlots)
+            return {nullptr, nullptr};
+        u32_t slot = lRhs * numOfSlots + rRhs;
+        const CompiledRule* base = compiledBinaryRules.data();
+        return {base + binaryOffsets[slot], base + binaryOffsets[slot + 1]};
+    }
+
+    /// Right symbols Z such that some rule X ::= lRhs Z exists
+    inline const std::vector<CFGSymbTy>& getRightSymbols(CFGSymbTy lRhs) const
+    { return lRhs < rightSymbols.size() ? rightSymbols[lRhs] : emptySymbols; }
+
+    /// Left symbols Y such that some rule X ::= Y rRhs exists
+    inline const std::vector<CFGSymbTy>& getLeftSymbols(CFGSymbTy rRhs) const
+    { return rRhs < leftSymbols.size() ? leftSymbols[rRhs] : emptySymbols; }
+
+    /// Rhs symbols Y of the rules lhs ::= Y
+    inline const std::vector<CFGSymbTy>& getUnaryRhs(CFGSymbTy lhs) const
+    { return lhs < unaryRhs.size() ? unaryRhs[lhs] : emptySymbols; }
+
+    /// Rhs symbol pairs (Y, Z) of the rules lhs ::= Y Z
+    inline const std::vector<std::pair<CFGSymbTy, CFGSymbTy>>& getBinaryRhs(CFGSymbTy lhs) const
+    { return lhs < binaryRhs.size() ? binaryRhs[lhs] : emptySymbolPairs; }
+
     Set<CFGSymbTy>& getEmptyRules()
     { return emptyRules; }
 
@@ -101,6 +197,8 @@ public:
     void readProduction(std::string& line);
     void readUCFLSymbol(std::string& line, LineTy ty);
     void detectTransitiveSymbol();
+    /// Rebuild the compiled rule tables; must be called again whenever unaryRules/binaryRules change
+    void compileRules();
     void printCFGStat();
 };
 
@@ -13,6 +13,8 @@
 
 namespace SVF
 {
+class FlatCFLData;
+
 /*!
  * Adjacency-list graph representation
  */
@@ -20,117 +22,232 @@ class CFLData
 {
 public:
     typedef std::map<const Label, NodeBS> TypeMap;
+    typedef TypeMap::value_type LabelEntry;     // <label, adjacent nodes>
+    typedef std::vector<LabelEntry*> LabelList;
     typedef std::unordered_map<NodeID, TypeMap> DataMap;
-    typedef typename DataMap::iterator iterator;
-    typedef typename DataMap::const_iterator const_iterator;
+
+    /*!
+     * Iterator over the label entries of a node, shared by all the data backends.
+     * A list-based iterator goes by position, so that entries appended during iteration do not invalidate it.
+     * In both backends an entry added during iteration is visited iff it is placed after the current one, in label
+     * order for a map and in insertion order for a list, so the end of a list is not fixed when the range is made.
+     */
+    class LabelIterator
+    {
+    private:
+        TypeMap::iterator mapIt;
+        const LabelList* list;
+        size_t pos;
+
+    public:
+        LabelIterator(TypeMap::iterator it) : mapIt(it), list(nullptr), pos(0)
+        {}
+
+        LabelIterator(const LabelList* l, size_t p) : list(l), pos(p)
+        {}
+
+        /// The end of a list, wherever it is when compared
+        static const size_t listEnd = ~(size_t) 0;
+
+        inline LabelEntry& operator*() const
+        { return list ? *(*list)[pos] : *mapIt; }
+
+        inline LabelEntry* operator->() const
+        { return &**this; }
+
+        inline LabelIterator& operator++()
+        {
+            if (list)
+                ++pos;
+            else
+                ++mapIt;
+            return *this;
+        }
+
+        inline bool operator==(const LabelIterator& rhs) const
+        {
+            if (!list)
+                return mapIt == rhs.mapIt;
+            bool atEnd = pos >= list->size();
+            return atEnd == rhs.pos >= list->size() && (atEnd || pos == rhs.pos);
+        }
+
+        inline bool operator!=(const LabelIterator& rhs) const
+        { return !(*this == rhs); }
+    };
+
+    /// Label entries of a node
+    class LabelRange
+    {
+    private:
+        LabelIterator _begin;
+        LabelIterator _end;
+
+    public:
+        LabelRange(TypeMap& typeMap) : _begin(typeMap.begin()), _end(typeMap.end())
+        {}
+
+        LabelRange(TypeMap::iterator b, TypeMap::iterator e) : _begin(b), _end(e)
+        {}
+
+        LabelRange(const LabelList& list) : _begin(&list, 0), _end(&list, LabelIterator::listEnd)
+        {}
+
+        inline LabelIterator begin() const
+        { return _begin; }
+
+        inline LabelIterator end() const
+        { return _end; }
+    };
 
 protected:
     DataMap succMap;
     DataMap predMap;
     const NodeBS emptyData;
+    const LabelList emptyList;
     NodeBS diff;
+    /// Whether this is a FlatCFLData, whose hot accessors are dispatched by it instead of virtual calls
+    const bool flat;
+
+    CFLData(bool _flat) : flat(_flat)
+    {}
 
 public:
     // Constructor
-    CFLData()
+    CFLData() : flat(false)
     {}
 
     // Destructor
     virtual ~CFLData() = default;
 
+    /// Create a data instance of the backend selected by option -flat-data
+    static CFLData* createCFLData();
+
     virtual void clear()
     {
         succMap.clear();
         predMap.clear();
     }
 
-    inline const_iterator begin() const
-    { return succMap.begin(); }
-
-    inline const_iterator end() const
-    { return succMap.end(); }
+    /// Nodes having (possibly empty) label entries
+    //@{
+    virtual NodeBS getSuccKeys() const
+    {
+        NodeBS keys;
+        for (auto& it : succMap)
+            keys.set(it.first);
+        return keys;
+    }
 
-    inline iterator begin()
-    { return succMap.begin(); }
+    virtual NodeBS getPredKeys() const
+    {
+        NodeBS keys;
+        for (auto& it : predMap)
+            keys.set(it.first);
+        return keys;
+    }
+    //@}
 
-    inline iterator end()
-    { return succMap.end(); }
+    virtual LabelRange getSuccs(const NodeID key)
+    { return LabelRange(succMap[key]); }
 
-    inline DataMap& getSuccMap()
-    { return succMap; }
+    virtual LabelRange getPreds(const NodeID key)
+    { return LabelRange(predMap[key]); }
 
-    inline DataMap& getPredMap()
-    { return predMap; }
+    /// Label entries of a node, nothing is created if absent so that concurrent readers are safe
+    //@{
+    virtual LabelRange findSuccs(const NodeID key)
+    { return findRange(succMap, key); }
 
-    inline TypeMap& getSuccs(const NodeID key)
-    { return succMap[key]; }
+    virtual LabelRange findPreds(const NodeID key)
+    { return findRange(predMap, key); }
+    //@}
 
-    inline TypeMap& getPreds(const NodeID key)
-    { return predMap[key]; }
+    /// Accessors of the solving loops, non-virtual so that the map backend is inlined (defined after FlatCFLData)
+    //@{
+    /// Label entries of a node whose labels have symbol symb, nothing is created if absent
+    inline LabelRange getSymbSuccs(const NodeID key, const CFGSymbTy symb);
+    inline LabelRange getSymbPreds(const NodeID key, const CFGSymbTy symb);
 
-    inline NodeBS& getSuccs(const NodeID key, const Label lbl)
-    { return succMap[key][lbl]; }
+    inline NodeBS& getSuccs(const NodeID key, const Label lbl);
+    inline NodeBS& getPreds(const NodeID key, const Label lbl);
 
-    inline NodeBS& getPreds(const NodeID key, const Label lbl)
-    { return predMap[key][lbl]; }
+    inline bool hasEdge(const NodeID src, const NodeID dst, const Label lbl);
+    //@}
 
     // Alias data operations
     //@{
     inline void addEdge(const NodeID src, const NodeID dst, const Label lbl)
     {
-        succMap[src][lbl].set(dst);
-        predMap[dst][lbl].set(src);
+        getSuccs(src, lbl).set(dst);
+        getPreds(dst, lbl).set(src);
     }
 
     inline void addEdges(const NodeID src, const NodeBS& dstSet, const Label lbl)
     {
-        if (succMap[src][lbl] |= dstSet)
+        if (getSuccs(src, lbl) |= dstSet)
         {
             for (const NodeID dst : dstSet)
-                predMap[dst][lbl].set(src);
+                getPreds(dst, lbl).set(src);
         }
     }
 
     inline void addEdges(const NodeBS& srcSet, const NodeID dst, const Label lbl)
     {
-        if (predMap[dst][lbl] |= srcSet)
+        if (getPreds(dst, lbl) |= srcSet)
         {
             for (const NodeID src : srcSet)
-                succMap[src][lbl].set(dst);
+                getSuccs(src, lbl).set(dst);
         }
     }
 
     inline bool checkAndAddEdge(const NodeID src, const NodeID dst, const Label lbl)
     {
-        succMap[src][lbl].test_and_set(dst);
-        return predMap[dst][lbl].test_and_set(src);
+        getSuccs(src, lbl).test_and_set(dst);
+        return getPreds(dst, lbl).test_and_set(src);
     }
 
+    /// The new edges are computed as a word-level difference, the reverse direction is only updated for them
     inline NodeBS checkAndAddEdges(const NodeID src, const NodeBS& dstSet, const Label lbl)
     {
         NodeBS newDsts;
-        if (succMap[src][lbl] |= dstSet)
-        {
-            for (const NodeID dst : dstSet)
-                if (predMap[dst][lbl].test_and_set(src))
-                    newDsts.set(dst);
-        }
+        NodeBS& succs = getSuccs(src, lbl);
+        newDsts.intersectWithComplement(dstSet, succs);
+        if (newDsts.empty())
+            return newDsts;
+
+        succs |= newDsts;
+        for (const NodeID dst : newDsts)
+            getPreds(dst, lbl).set(src);
         return newDsts;
     }
 
     inline NodeBS checkAndAddEdges(const NodeBS& srcSet, const NodeID dst, const Label lbl)
     {
         NodeBS newSrcs;
-        if (predMap[dst][lbl] |= srcSet)
-        {
-            for (const NodeID src : srcSet)
-                if (succMap[src][lbl].test_and_set(dst))
-                    newSrcs.set(src);
-        }
+        NodeBS& preds = getPreds(dst, lbl);
+        newSrcs.intersectWithComplement(srcSet, preds);
+        if (newSrcs.empty())
+            return newSrcs;
+
+        preds |= newSrcs;
+        for (const NodeID src : newSrcs)
+            getSuccs(src, lbl).set(dst);
         return newSrcs;
     }
 
-    inline bool hasEdge(const NodeID src, const NodeID dst, const Label lbl)
+    /* This is a dataset version, to be modified to a cflData version */
+    virtual void clearEdges(const NodeID key)
+    {
+        succMap[key].clear();
+        predMap[key].clear();
+    }
+    //@}
+
+private:
+    inline FlatCFLData* toFlat();
+
+    inline bool hasMapEdge(const NodeID src, const NodeID dst, const Label lbl)
     {
         auto it1 = succMap.find(src);
         if (it1 == succMap.end())
@@ -143,16 +260,287 @@ public:
         return it2->second.test(dst);
     }
 
-    /* This is a dataset version, to be modified to a cflData version */
-    inline void clearEdges(const NodeID key)
+    inline LabelRange findRange(DataMap& dataMap, const NodeID key)
     {
-        succMap[key].clear();
-        predMap[key].clear();
+        auto it = dataMap.find(key);
+        if (it == dataMap.end())
+            return LabelRange(emptyList);
+        return LabelRange(it->second);
+    }
+
+    /// Labels are ordered by symbol first, so the entries of a symbol are contiguous in a TypeMap
+    inline LabelRange getSymbRange(DataMap& dataMap, const NodeID key, const CFGSymbTy symb)
+    {
+        auto it = dataMap.find(key);
+        if (it == dataMap.end())
+            return LabelRange(emptyList);
+        TypeMap& typeMap = it->second;
+        return LabelRange(typeMap.lower_bound(Label(symb, 0)), typeMap.lower_bound(Label(symb + 1, 0)));
+    }
+};
+
+
+/*!
+ * Adjacency-list graph representation with flat storage.
+ * Labels are interned into dense indices, the entry of each (node, label) is located by a single probe of an
+ * open-addressing table, and the label entries of each node are kept in a position-indexed list.
+ */
+class FlatCFLData : public CFLData
+{
+    friend class CFLData;
+
+private:
+    /// Open-addressing table with linear probing, keyed by (node, 32-bit index)
+    template<class T>
+    struct ProbeTable
+    {
+        struct Slot
+        {
+            u64_t key;
+            T* value;
+        };
+
+        std::vector<Slot> slots;
+        u32_t numOfValues;
+
+        ProbeTable()
+        { clear(); }
+
+        inline void clear()
+        {
+            slots.assign(1024, Slot{emptyKey, nullptr});
+            numOfValues = 0;
+        }
+
+        inline T* find(const u64_t key) const
+        {
+            u64_t mask = slots.size() - 1;
+            for (u64_t i = hashKey(key) & mask;; i = (i + 1) & mask)
+            {
+                if (slots[i].key == key)
+                    return slots[i].value;
+                if (slots[i].key == emptyKey)
+                    return nullptr;
+            }
+        }
+
+        /// Insert a key known to be absent
+        inline void insert(const u64_t key, T* value)
+        {
+            u64_t mask = slots.size() - 1;
+            u64_t i = hashKey(key) & mask;
+            while (slots[i].key != emptyKey)
+                i = (i + 1) & mask;
+            slots[i] = Slot{key, value};
+
+            if (++numOfValues * 2 > slots.size())
+                rehash();
+        }
+
+        /// Double the capacity
+        void rehash()
+        {
+            std::vector<Slot> oldSlots(slots.size() * 2, Slot{emptyKey, nullptr});
+            oldSlots.swap(slots);
+
+            u64_t mask = slots.size() - 1;
+            for (const Slot& slot : oldSlots)
+            {
+                if (slot.key == emptyKey)
+                    continue;
+
+                u64_t i = hashKey(slot.key) & mask;
+                while (slots[i].key != emptyKey)
+                    i = (i + 1) & mask;
+                slots[i] = slot;
+            }
+        }
+    };
+
+    /// Entries of one direction (succ or pred)
+    struct EntryTable
+    {
+        ProbeTable<LabelEntry> entries;     // keyed by (node, label index)
+        ProbeTable<LabelList> groups;       // entries of the same symbol, keyed by (node, symbol)
+        std::deque<LabelList> lists;        // label entries of each node, indexed by node ID
+        std::deque<LabelList> groupPool;
+        NodeBS keys;                        // nodes having entries, i.e., non-empty lists
+        u64_t lastKey;                      // the most recently accessed entry
+        LabelEntry* lastEntry;
+
+        EntryTable()
+        { clear(); }
+
+        void clear();
+
+        inline LabelList& getList(const NodeID key)
+        {
+            if (key >= lists.size())
+                lists.resize(key + 1);
+            return lists[key];
+        }
+
+        inline LabelEntry* find(const u64_t key)
+        {
+            if (key == lastKey)
+                return lastEntry;
+
+            LabelEntry* entry = entries.find(key);
+            if (entry)
+            {
+                lastKey = key;
+                lastEntry = entry;
+            }
+            return entry;
+        }
+    };
+
+    static const u64_t emptyKey = ~0ULL;
+
+    /// Label interning
+    Map<Label, u32_t> labelToIdxMap;
+    Label lastLabel;
+    u32_t lastIdx;
+
+    EntryTable succTable;
+    EntryTable predTable;
+
+    /// Storage of all the entries, never moved once created
+    std::deque<LabelEntry> entryPool;
+
+public:
+    FlatCFLData() : CFLData(true), lastLabel(0, 0), lastIdx(0)
+    { labelToIdxMap[lastLabel] = lastIdx; }
+
+    using CFLData::getSuccs;
+    using CFLData::getPreds;
+
+    void clear() override;
+
+    NodeBS getSuccKeys() const override
+    { return succTable.keys; }
+
+    NodeBS getPredKeys() const override
+    { return predTable.keys; }
+
+    LabelRange getSuccs(const NodeID key) override
+    { return LabelRange(succTable.getList(key)); }
+
+    LabelRange getPreds(const NodeID key) override
+    { return LabelRange(predTable.getList(key)); }
+
+    LabelRange findSuccs(const NodeID key) override
+    { return key < succTable.lists.size() ? LabelRange(succTable.lists[key]) : LabelRange(emptyList); }
+
+    LabelRange findPreds(const NodeID key) override
+    { return key < predTable.lists.size() ? LabelRange(predTable.lists[key]) : LabelRange(emptyList); }
+
+    void clearEdges(const NodeID key) override
+    {
+        for (LabelEntry* entry : succTable.getList(key))
+            entry->second.clear();
+        for (LabelEntry* entry : predTable.getList(key))
+            entry->second.clear();
+    }
+
+private:
+    /// Hot accessors, dispatched by those of CFLData
+    //@{
+    inline LabelRange getFlatSymbSuccs(const NodeID key, const CFGSymbTy symb)
+    { return getSymbRange(succTable, key, symb); }
+
+    inline LabelRange getFlatSymbPreds(const NodeID key, const CFGSymbTy symb)
+    { return getSymbRange(predTable, key, symb); }
+
+    inline NodeBS& getFlatSuccs(const NodeID key, const Label lbl)
+    { return getEntry(succTable, key, lbl)->second; }
+
+    inline NodeBS& getFlatPreds(const NodeID key, const Label lbl)
+    { return getEntry(predTable, key, lbl)->second; }
+
+    inline bool hasFlatEdge(const NodeID src, const NodeID dst, const Label lbl)
+    {
+        LabelEntry* entry = succTable.find(makeKey(src, getLabelIdx(lbl)));
+        return entry && entry->second.test(dst);
     }
     //@}
+
+    inline LabelRange getSymbRange(EntryTable& table, const NodeID key, const CFGSymbTy symb)
+    {
+        LabelList* group = table.groups.find(makeKey(key, symb));
+        return group ? LabelRange(*group) : LabelRange(emptyList);
+    }
+
+    static inline u64_t makeKey(const NodeID key, const u32_t lblIdx)
+    { return ((u64_t) key << 32) | lblIdx; }
+
+    /// Finalizer of splitmix64
+    static inline u64_t hashKey(u64_t x)
+    {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    inline u32_t getLabelIdx(const Label lbl)
+    {
+        if (lbl == lastLabel)
+            return lastIdx;
+
+        auto resIns = labelToIdxMap.insert(std::make_pair(lbl, labelToIdxMap.size()));
+        lastLabel = lbl;
+        lastIdx = resIns.first->second;
+        return lastIdx;
+    }
+
+    /// Get the entry of (key, lbl), create one if not exists
+    inline LabelEntry* getEntry(EntryTable& table, const NodeID key, const Label lbl)
+    {
+        u64_t slotKey = makeKey(key, getLabelIdx(lbl));
+        if (LabelEntry* entry = table.find(slotKey))
+            return entry;
+
+        entryPool.emplace_back(lbl, NodeBS());
+        LabelEntry* entry = &entryPool.back();
+        table.entries.insert(slotKey, entry);
+        table.getList(key).push_back(entry);
+        table.keys.set(key);
+        table.lastKey = slotKey;
+        table.lastEntry = entry;
+
+        u64_t groupKey = makeKey(key, lbl.first);
+        LabelList* group = table.groups.find(groupKey);
+        if (!group)
+        {
+            table.groupPool.emplace_back();
+            group = &table.groupPool.back();
+            table.groups.insert(groupKey, group);
+        }
+        group->push_back(entry);
+        return entry;
+    }
 };
 
 
+inline FlatCFLData* CFLData::toFlat()
+{ return static_cast<FlatCFLData*>(this); }
+
+inline CFLData::LabelRange CFLData::getSymbSuccs(const NodeID key, const CFGSymbTy symb)
+{ return flat ? toFlat()->getFlatSymbSuccs(key, symb) : getSymbRange(succMap, key, symb); }
+
+inline CFLData::LabelRange CFLData::getSymbPreds(const NodeID key, const CFGSymbTy symb)
+{ return flat ? toFlat()->getFlatSymbPreds(key, symb) : getSymbRange(predMap, key, symb); }
+
+inline NodeBS& CFLData::getSuccs(const NodeID key, const Label lbl)
+{ return flat ? toFlat()->getFlatSuccs(key, lbl) : succMap[key][lbl]; }
+
+inline NodeBS& CFLData::getPreds(const NodeID key, const Label lbl)
+{ return flat ? toFlat()->getFlatPreds(key, lbl) : predMap[key][lbl]; }
+
+inline bool CFLData::hasEdge(const NodeID src, const NodeID dst, const Label lbl)
+{ return flat ? toFlat()->hasFlatEdge(src, dst, lbl) : hasMapEdge(src, dst, lbl); }
+
+
 /*!
  * Hybrid graph representation for transitive relations
  */
@@ -174,7 +562,7 @@ public:
         { return id < rhs.id; }
     };
 
-    u32_t checks;
+    u64_t checks;
 
     Map<NodeID, std::unordered_map<NodeID, TreeNode*>> indMap;   // indMap[v][u] points to node v in tree(u)
 
@@ -41,7 +41,7 @@ public:
         copyBuild(rhs);
     }
 
-    void readGraph(std::string fname);   /// build from graph file
+    void readGraph(std::string fname);   /// build from a text or binary graph file
     void copyBuild(const CFLGraph& rhs);           /// copy builder
 
     void destroy()
@@ -64,7 +64,7 @@ public:
     };
 
     /// calculators
-    u32_t checks;
+    u64_t checks;
 
 protected:
     std::unordered_map<NodeID, NodeID> nodeToRepMap;
@@ -94,6 +94,12 @@ public:
             return id;
         return it->second;
     }
+
+    inline bool hasNode(NodeID id) const
+    { return idToNodeMap.find(id) != idToNodeMap.end(); }
+
+    inline const std::unordered_map<NodeID, ECGNode*>& getNodes() const
+    { return idToNodeMap; }
     //@}
 
     /// edge methods
@@ -156,6 +162,12 @@ public:
     inline void setReachable(NodeID n, NodeID tgt)
     { reachableMap[n].set(tgt); }
 
+    inline void setReachables(NodeID n, const NodeBS& tgts)
+    { reachableMap[n] |= tgts; }
+
+    inline const std::unordered_map<NodeID, NodeBS>& getReachableMap() const
+    { return reachableMap; }
+
     inline void recordNewEdge(NodeID n, NodeID tgt)
     { newEdgeMap[n].set(tgt); }
     //@}
@@ -252,6 +264,9 @@ public:
 
     inline void setReachable(NodeID n, NodeID tgt)
     { reachableMap[n].set(tgt); }
+
+    inline const std::unordered_map<NodeID, NodeBS>& getReachableMap() const
+    { return reachableMap; }
     //@}
 
     /// graph methods
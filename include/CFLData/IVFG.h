@@ -47,7 +47,7 @@ public:
     /// Constructor
     IVFG();
 
-    void readGraph(std::string fname);   /// build from graph file
+    void readGraph(std::string fname);   /// build from a text or binary graph file
     void copyBuild(const IVFG& rhs);  /// copy builder
 
     /// copy constructor
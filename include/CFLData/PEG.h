@@ -46,7 +46,7 @@ public:
         copyBuild(rhs);
     }
 
-    void readGraph(std::string fname);   /// build from graph file
+    void readGraph(std::string fname);   /// build from a text or binary graph file
     void copyBuild(const PEG& rhs);           /// copy builder
 
     void destroy()
@@ -0,0 +1,193 @@
+//
+// Saved states of CFL solvers
+//
+
+#ifndef POCR_SVF_SOLVERSTATE_H
+#define POCR_SVF_SOLVERSTATE_H
+
+#include "ECG.h"
+#include <cstring>
+
+namespace SVF
+{
+/*!
+ * Binary file of a solver state, for resuming solving on changed edges or from a checkpoint, and for querying
+ * solved edges.
+ * A file starts with a header naming the kind of the solver that wrote it, followed by tagged sections,
+ * each prefixed by its length so that readers may skip the sections they do not know.
+ *
+ * Node IDs are written in ascending order as varint deltas, and node sets as the raw words of their
+ * 128-bit sparse bit vector elements, each after the varint delta of its element index.
+ * Spanning trees are written in preorder, so that they are rebuilt without looking up parents.
+ */
+class StateWriter
+{
+public:
+    static const u32_t Version = 3;
+
+    enum SectionTy
+    {
+        Symbols = 1,    // symbol IDs and names
+        Info,           // solver-specific counters
+        Nodes,          // input nodes
+        Data,           // CFL data
+        InputData,      // input edges
+        Trees,          // a symbol and the spanning trees of the symbol
+        ECGs,           // a symbol and the ECG of the symbol
+        Worklist        // pending items of a checkpoint
+    };
+
+private:
+    std::ofstream out;
+    /// The state is written into image instead of a file if set
+    std::vector<char>* image;
+    u64_t sectionStart;
+    /// Buffers reused across node sets
+    std::vector<u32_t> elemIdxs;
+    std::vector<u64_t> elemWords;
+
+public:
+    StateWriter(const std::string& fname, const std::string& kind);
+    /// A state written into memory, e.g., to be written into a file by another thread
+    StateWriter(std::vector<char>& _image, const std::string& kind);
+
+    inline bool good() const
+    { return image || (bool) out; }
+
+    /// A section is written between its begin and end
+    //@{
+    void beginSection(SectionTy tag);
+    void endSection();
+    //@}
+
+    /// Scalars and node sets
+    //@{
+    template<class T>
+    inline void write(const T& val)
+    { put((const char*) &val, sizeof(T)); }
+
+    void writeVarint(u64_t val);
+    void writeString(const std::string& str);
+    void writeNodeBS(const NodeBS& bs);
+    //@}
+
+    /// Solver data
+    //@{
+    void writeSymbols(const Map<CFGSymbTy, std::string>& symbols);
+    void writeData(CFLData& data);
+    void writeTrees(HybridData& trees);
+    void writeECG(const ECG& ecg);
+    //@}
+
+private:
+    inline void put(const char* data, size_t len)
+    {
+        if (image)
+            image->insert(image->end(), data, data + len);
+        else
+            out.write(data, len);
+    }
+
+    inline u64_t tell()
+    { return image ? image->size() : (u64_t) out.tellp(); }
+
+    void writeHeader(const std::string& kind);
+};
+
+
+/*!
+ * The file is mapped into memory, and a section is read after opening it
+ */
+class StateReader
+{
+public:
+    struct Section
+    {
+        u32_t tag;
+        const char* begin;
+        const char* end;
+    };
+
+private:
+    void* base;
+    size_t length;
+    bool failed;
+    std::string kind;
+    std::vector<Section> sections;
+    /// Read position and end of the opened section
+    const char* pos;
+    const char* end;
+
+public:
+    explicit StateReader(const std::string& fname);
+
+    /// A reader of a part of a section of a mapped state, which reads it in place,
+    /// e.g., a reader for each query of a query server
+    StateReader(const char* _pos, const char* _end);
+
+    ~StateReader();
+
+    /// Whether the file is a state file and nothing has failed so far
+    inline bool good() const
+    { return !failed; }
+
+    /// Mark the state as not matching the solver
+    inline void setFailed()
+    { failed = true; }
+
+    inline const std::string& getKind() const
+    { return kind; }
+
+    /// Open the nth section of a tag, false if there is none
+    bool openSection(StateWriter::SectionTy tag, u32_t nth = 0);
+
+    /// Read position and end of the opened section
+    //@{
+    inline const char* getPos() const
+    { return pos; }
+
+    inline const char* getEnd() const
+    { return end; }
+    //@}
+
+    /// Scalars and node sets of the opened section
+    //@{
+    template<class T>
+    inline T read()
+    {
+        T val = T();
+        if (end - pos < (ptrdiff_t) sizeof(T))
+        {
+            failed = true;
+            return val;
+        }
+        memcpy(&val, pos, sizeof(T));
+        pos += sizeof(T);
+        return val;
+    }
+
+    u64_t readVarint();
+    std::string readString();
+    void readNodeBS(NodeBS& bs);
+    /// Skip a node set, and whether it has id
+    bool findInNodeBS(NodeID id);
+
+    inline void skipNodeBS()
+    { findInNodeBS(0); }
+
+    /// The nodes of a tree of a trees section after its root ID, added to nodes if given
+    void readTreeNodes(NodeBS* nodes);
+    //@}
+
+    /// Solver data, added to the given (possibly non-empty) ones
+    //@{
+    void readSymbols(Map<CFGSymbTy, std::string>& symbols);
+    void readData(CFLData& data);
+    void readTrees(HybridData& trees);
+    void readECG(ECG& ecg);
+    //@}
+};
+
+}
+
+#endif //POCR_SVF_SOLVERSTATE_H
@@ -15,6 +15,8 @@
 #include <Util/SCC.h>
 #include "CFLData/CFLData.h"
 #include "CFLOpt.h"
+#include "ProgressSampler.h"
+#include "SolveBudget.h"
 #include <fstream>
 #include <thread>
 #include <pthread.h>
@@ -73,6 +75,140 @@ public:
 };
 
 
+/*!
+ * FIFO worklist of CFL items.
+ * Items are packed into three 32-bit words and stored in a ring buffer, and whether an item is in the list is
+ * recorded by a bitmap of dsts per (label, src) instead of hashing whole items.
+ */
+class CFLWorkList
+{
+private:
+    struct PackedItem
+    {
+        NodeID src;
+        NodeID dst;
+        u32_t lbl;      // label index, with the highest bit marking a secondary item
+    };
+
+    static const u32_t secondaryBit = 1U << 31;
+
+    /// Ring buffer
+    //@{
+    std::vector<PackedItem> items;
+    u64_t head;
+    u64_t tail;
+    //@}
+
+    /// In-list dsts of each (label index, src)
+    Map<u64_t, NodeBS> inList;
+
+    /// Label interning
+    //@{
+    Map<Label, u32_t> labelToIdxMap;
+    std::vector<Label> labels;
+    Label lastLabel;
+    u32_t lastIdx;
+    //@}
+
+public:
+    CFLWorkList() : items(1024), head(0), tail(0), lastLabel(0, 0), lastIdx(0)
+    {
+        labelToIdxMap[lastLabel] = lastIdx;
+        labels.push_back(lastLabel);
+    }
+
+    inline bool empty() const
+    { return head == tail; }
+
+    inline u64_t size() const
+    { return tail - head; }
+
+    /// Nothing is interned for a label never pushed, which cannot be in the list
+    inline bool find(const CFLItem& item) const
+    {
+        auto lblIt = labelToIdxMap.find(item.label());
+        if (lblIt == labelToIdxMap.end())
+            return false;
+
+        u32_t lbl = lblIt->second | (item.isPrimary() ? 0 : secondaryBit);
+        auto it = inList.find(makeKey(lbl, item.src()));
+        return it != inList.end() && it->second.test(item.dst());
+    }
+
+    inline bool push(const CFLItem& item)
+    {
+        u32_t lbl = getLabelIdx(item.label()) | (item.isPrimary() ? 0 : secondaryBit);
+        if (!inList[makeKey(lbl, item.src())].test_and_set(item.dst()))
+            return false;
+
+        if (tail - head == items.size())
+            grow();
+        items[tail & (items.size() - 1)] = PackedItem{item.src(), item.dst(), lbl};
+        tail++;
+        return true;
+    }
+
+    inline CFLItem pop()
+    {
+        assert(!empty() && "work list is empty");
+        PackedItem pItem = items[head & (items.size() - 1)];
+        head++;
+
+        auto it = inList.find(makeKey(pItem.lbl, pItem.src));
+        it->second.reset(pItem.dst);
+        if (it->second.empty())
+            inList.erase(it);
+
+        return CFLItem(pItem.src, pItem.dst, labels[pItem.lbl & ~secondaryBit], !(pItem.lbl & secondaryBit));
+    }
+
+    inline void clear()
+    {
+        head = tail = 0;
+        inList.clear();
+    }
+
+    /// Visit the items in the list from the head, without popping them
+    template<class F>
+    inline void forEach(F fn) const
+    {
+        for (u64_t i = head; i != tail; ++i)
+        {
+            const PackedItem& pItem = items[i & (items.size() - 1)];
+            fn(CFLItem(pItem.src, pItem.dst, labels[pItem.lbl & ~secondaryBit], !(pItem.lbl & secondaryBit)));
+        }
+    }
+
+private:
+    static inline u64_t makeKey(const u32_t lbl, const NodeID src)
+    { return ((u64_t) lbl << 32) | src; }
+
+    inline u32_t getLabelIdx(const Label lbl)
+    {
+        if (lbl == lastLabel)
+            return lastIdx;
+
+        auto resIns = labelToIdxMap.insert(std::make_pair(lbl, labels.size()));
+        if (resIns.second)
+            labels.push_back(lbl);
+        lastLabel = lbl;
+        lastIdx = resIns.first->second;
+        return lastIdx;
+    }
+
+    /// Double the ring buffer, keeping the order of items
+    void grow()
+    {
+        std::vector<PackedItem> newItems(items.size() * 2);
+        for (u64_t i = head; i != tail; ++i)
+            newItems[i - head] = items[i & (items.size() - 1)];
+        tail -= head;
+        head = 0;
+        items.swap(newItems);
+    }
+};
+
+
 /*
  * Generic CFL solver for all-pair analysis based on different graphs (e.g. PAG, VFG, ThreadVFG)
  * Extend this class for sophisticated CFL-reachability resolution (e.g. field, flow, path)
@@ -80,21 +216,38 @@ public:
 class CFLBase
 {
 public:
-    typedef FIFOWorkList<CFLItem> WorkList;
+    typedef CFLWorkList WorkList;
+    typedef std::pair<NodeID, Label> SetItem;     // <src, label>, the dsts are kept in pendingDsts
+    typedef FIFOWorkList<SetItem> SetWorkList;
 
 protected:
     /// Worklist for resolution
     WorkList worklist;
+    /// Worklist for set-at-a-time resolution
+    //@{
+    bool setMode;
+    SetWorkList setWorklist;
+    Map<SetItem, NodeBS> pendingDsts;
+    //@}
     /// Alias dataset
     CFLData* _cflData;
     const NodeBS emptyBS;
+    /// Counters of a progress sampler (-progress), null when not sampled
+    SolverProgress* progress;
+    /// Budgets of solving, null when not watched
+    const SolveBudget* budget;
+    /// Set when a checkpoint is due (-checkpoint), null without checkpoints
+    const std::atomic<bool>* checkpointDue;
+    /// Whether solving stopped at a budget before the fixpoint
+    bool partial;
 
 public:
     /// Constructor
-    CFLBase() : _cflData(NULL)
+    CFLBase() : setMode(false), _cflData(NULL), progress(nullptr), budget(nullptr),
+                checkpointDue(nullptr), partial(false)
     {
         if (!_cflData)
-            _cflData = new CFLData();
+            _cflData = CFLData::createCFLData();
     }
 
     /// Destructor
@@ -104,13 +257,45 @@ public:
     CFLData* cflData()
     { return _cflData; }
 
+    /// Propagate sets of edges keyed by (src, label) instead of single edges,
+    /// only for solvers deriving edges in processSetItem()
+    inline void setSetMode(bool mode)
+    { setMode = mode; }
+
     // worklist operations
     //@{
     virtual inline CFLItem popFromWorklist()
     { return worklist.pop(); }
 
     virtual inline bool pushIntoWorklist(CFLItem item)
-    { return worklist.push(item); }
+    {
+        if (setMode)
+            return pushIntoSetWorklist(item.src(), item.dst(), item.label());
+        return worklist.push(item);
+    }
+
+    /// Set-mode worklist operations
+    //@{
+    inline bool pushIntoSetWorklist(NodeID src, NodeID dst, Label ty)
+    {
+        SetItem setItem(src, ty);
+        if (!pendingDsts[setItem].test_and_set(dst))
+            return false;
+        setWorklist.push(setItem);
+        return true;
+    }
+
+    inline bool pushIntoSetWorklist(NodeID src, const NodeBS& dstSet, Label ty)
+    {
+        if (dstSet.empty())
+            return false;
+        SetItem setItem(src, ty);
+        if (!(pendingDsts[setItem] |= dstSet))
+            return false;
+        setWorklist.push(setItem);
+        return true;
+    }
+    //@}
 
     virtual inline bool pushIntoWorklist(NodeID src, NodeID dst, Label ty, bool isPrimary = true)
     { return pushIntoWorklist(CFLItem(src, dst, ty, isPrimary)); }
@@ -122,13 +307,56 @@ public:
     { return isInWorklist(CFLItem(src, dst, ty)); }
 
     virtual inline bool isWorklistEmpty()
-    { return worklist.empty(); }
+    { return setMode ? setWorklist.empty() : worklist.empty(); }
+
+    virtual inline u64_t getWorklistSize()
+    { return setMode ? setWorklist.size() : worklist.size(); }
+    //@}
+
+    /// Progress of solving
+    //@{
+    inline void setProgress(SolverProgress* _progress)
+    { progress = _progress; }
+
+    virtual u64_t getNumOfChecks() const
+    { return 0; }
+
+    inline void countItem(const Label& lbl)
+    {
+        if (progress && progress->countItem(lbl.first))
+            publishProgress();
+    }
+
+    inline void publishProgress()
+    {
+        if (progress)
+            progress->publish(getWorklistSize(), getNumOfChecks());
+    }
+    //@}
+
+    /// Budgets of solving, checked by solvers at their safe points
+    //@{
+    inline void setBudget(const SolveBudget* _budget)
+    { budget = _budget; }
+
+    inline bool isStopped() const
+    { return budget && budget->isExceeded(); }
+
+    inline void setCheckpointDue(const std::atomic<bool>* due)
+    { checkpointDue = due; }
+
+    /// Whether the solver should leave solve() at its next safe point, to stop or to write a checkpoint
+    inline bool isInterrupted() const
+    { return isStopped() || (checkpointDue && checkpointDue->load(std::memory_order_relaxed)); }
+
+    inline bool isPartial() const
+    { return partial; }
     //@}
 
     //CFL data operations
     //@{
-    virtual Set<Label> unarySumm(Label lty) = 0;
-    virtual Set<Label> binarySumm(Label lty, Label rty) = 0;
+    virtual LabelSet unarySumm(Label lty) = 0;
+    virtual LabelSet binarySumm(Label lty, Label rty) = 0;
 
     inline virtual bool checkAndAddEdge(const NodeID srcId, const NodeID dstId, const Label ty)
     {
@@ -154,13 +382,53 @@ public:
 
     virtual void solve()
     {
-        while (!isWorklistEmpty())
+        if (setMode)
+        {
+            while (!setWorklist.empty() && !isInterrupted())
+            {
+                SetItem setItem = setWorklist.pop();
+                countItem(setItem.second);
+                auto it = pendingDsts.find(setItem);
+                NodeBS dstSet = std::move(it->second);
+                pendingDsts.erase(it);
+                processSetItem(setItem.first, dstSet, setItem.second);
+            }
+            return;
+        }
+
+        while (!isWorklistEmpty() && !isInterrupted())
         {
             CFLItem item = popFromWorklist();
+            countItem(item.label());
             processCFLItem(item);
         }
     }
 
+    /// Process the new edges src --ty--> dstSet as a whole
+    virtual void processSetItem(NodeID src, const NodeBS& dstSet, Label ty)
+    {
+        /// Derive edges via unary production rules
+        for (Label newTy : unarySumm(ty))
+            pushIntoSetWorklist(src, checkAndAddEdges(src, dstSet, newTy), newTy);
+
+        /// Derive edges via binary production rules
+        //@{
+        for (NodeID dst : dstSet)
+        {
+            for (auto& iter : cflData()->getSuccs(dst))
+                for (Label newTy : binarySumm(ty, iter.first))
+                    pushIntoSetWorklist(src, checkAndAddEdges(src, iter.second, newTy), newTy);
+        }
+
+        for (auto& iter : cflData()->getPreds(src))
+        {
+            for (Label newTy : binarySumm(iter.first, ty))
+                for (NodeID lSrc : iter.second)
+                    pushIntoSetWorklist(lSrc, checkAndAddEdges(lSrc, dstSet, newTy), newTy);
+        }
+        //@}
+    }
+
     virtual void processCFLItem(CFLItem item)
     {
         /// Derive edges via unary production rules
@@ -175,14 +443,10 @@ public:
             Label rty = iter.first;
             for (Label newTy : binarySumm(item.label(), rty))
             {
-//                NodeBS diffDsts = checkAndAddEdges(item.src(), iter.second, newTy);
-//                for (NodeID diffDst : diffDsts)
-//                    pushIntoWorklist(item.src(), diffDst, newTy);
                 for (NodeID dst : iter.second)
                 {
                     if (checkAndAddEdge(item.src(), dst, newTy))
                         pushIntoWorklist(item.src(), dst, newTy);
-
                 }
             }
         }
@@ -192,9 +456,6 @@ public:
             Label lty = iter.first;
             for (Label newTy : binarySumm(lty, item.label()))
             {
-//                NodeBS diffSrcs = checkAndAddEdges(iter.second, item.dst(), newTy);
-//                for (NodeID diffSrc : diffSrcs)
-//                    pushIntoWorklist(diffSrc, item.dst(), newTy);
                 for (NodeID src : iter.second)
                 {
                     if (checkAndAddEdge(src, item.dst(), newTy))
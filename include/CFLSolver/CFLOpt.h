@@ -28,6 +28,25 @@ public:
     static Option<bool> ucfl;
     static const Option<std::string> sPairsFName;
     static const Option<bool> ecgSCC;
+    static const Option<bool> flatData;
+    static const Option<bool> setProp;
+    static const Option<u32_t> threads;
+    static const Option<u32_t> memBudget;
+    static const Option<std::string> partDir;
+    static const Option<std::string> saveState;
+    static const Option<std::string> loadState;
+    static const Option<std::string> removedEdges;
+    static const Option<std::string> serve;
+    static const Option<u32_t> serveThreads;
+    static const Option<std::string> profileRules;
+    static const Option<std::string> statFormat;
+    static const Option<std::string> statFile;
+    static const Option<u32_t> progress;
+    static const Option<u32_t> timeBudget;
+    static const Option<u32_t> rssBudget;
+    static const Option<std::string> checkpoint;
+    static const Option<u32_t> checkpointInterval;
+    static const Option<std::string> resume;
 };
 
 }  // namespace SVF
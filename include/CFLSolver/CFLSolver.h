@@ -10,6 +10,11 @@
 #include "CFLData/CFLGraph.h"
 #include "CFLStat.h"
 #include "CFLData/ECG.h"
+#include "Checkpointer.h"
+#include "QueryServer.h"
+#include "RuleProfiler.h"
+#include <atomic>
+#include <mutex>
 
 namespace SVF
 {
@@ -29,6 +34,17 @@ protected:
     std::string graphName;
     CFG* _grammar;
     CFLGraph* _graph;
+    /// Nodes and edges of the input graph
+    NodeBS inputNodes;
+    u32_t numOfInputEdges;
+    /// Input nodes of the state resumed from
+    NodeBS restoredNodes;
+    /// Input edges, kept apart from derived ones only for solver states and demand-driven solving
+    CFLData inputData;
+    /// Counters of production rules (-profile-rules), null when not profiling
+    RuleProfiler* profiler;
+    /// Periodic checkpoints (-checkpoint), null without checkpoints
+    Checkpointer* checkpointer;
 
 public:
     StdCFL(std::string& _grammarName, std::string& _graphName) : stat(nullptr),
@@ -36,11 +52,16 @@ public:
                                                                  grammarName(_grammarName),
                                                                  graphName(_graphName),
                                                                  _grammar(nullptr),
-                                                                 _graph(nullptr)
+                                                                 _graph(nullptr),
+                                                                 numOfInputEdges(0),
+                                                                 profiler(nullptr),
+                                                                 checkpointer(nullptr)
     {}
 
     ~StdCFL() override
     {
+        delete checkpointer;
+        delete profiler;
         delete _grammar;
         _grammar = nullptr;
         delete _graph;
@@ -52,6 +73,12 @@ public:
     virtual CFG* grammar()
     { return _grammar; }
 
+    inline const std::string& getGrammarName() const
+    { return grammarName; }
+
+    inline const std::string& getGraphName() const
+    { return graphName; }
+
     /// Graph
     //@{
     const inline CFLGraph* graph() const
@@ -59,27 +86,107 @@ public:
 
     virtual CFLGraph* graph()
     { return _graph; }
+
+    /// The CFLGraph is only built for graph simplification and graph writing,
+    /// otherwise graph() is null and edges are read into the CFL data directly
+    static bool needGraph();
+
+    inline const NodeBS& getInputNodes() const
+    { return inputNodes; }
+
+    inline u32_t getNumOfInputEdges() const
+    { return numOfInputEdges; }
+
+    /// Input nodes not in the state resumed from, i.e., all the input nodes without -load-state
+    inline NodeBS getNewInputNodes() const
+    {
+        NodeBS newNodes;
+        newNodes.intersectWithComplement(inputNodes, restoredNodes);
+        return newNodes;
+    }
     //@}
 
     virtual void initialize();
     virtual void initSolver();
+    /// Add input edges from the graph or the graph file into the CFL data and the worklist
+    void readInputEdges();
+    /// Read the edges of a graph file with labels of the grammar
+    void readGraphFile(const std::string& fname, const std::function<void(NodeID, NodeID, Label)>& edgeFn);
+    virtual void addInputEdge(NodeID src, NodeID dst, Label lbl);
     virtual void finalize();
     virtual void analyze();
 
+    /// Solver states (-save-state and -load-state), the kind is empty for solvers without states.
+    /// A state is saved at the fixpoint, so that solving resumed from it only processes the added edges.
+    //@{
+    virtual std::string getStateKind() const
+    { return "std"; }
+
+    static bool keepInputEdges();
+    void storeState(const std::string& fname);
+    void restoreState(const std::string& fname, bool isCheckpoint = false);
+    virtual void saveState(StateWriter& writer);
+    virtual void loadState(StateReader& reader);
+    //@}
+
+    /// Checkpoints (-checkpoint and -resume) are states with the pending items, written while solving
+    //@{
+    virtual bool canCheckpoint() const
+    { return !getStateKind().empty(); }
+
+    inline std::string getCheckpointKind() const
+    { return getStateKind() + "-checkpoint"; }
+
+    void saveWorklist(StateWriter& writer);
+    void loadWorklist(StateReader& reader);
+    /// Solve, leaving solve() to write the checkpoints that are due
+    void solveWithCheckpoints(double solvingSince);
+    void writeCheckpoint(double solvingSince);
+    //@}
+
+    /// Answer queries (-serve) from the CFL data, which holds all the edges of the solvers with states
+    void serveQueries(const std::string& sockPath);
+
+    /// Removal of input edges from a resumed state by delete and rederive (DRed):
+    /// edges derived through removed ones are deleted, and those still derivable are derived again
+    //@{
+    void removeInputEdges(const std::string& fname);
+    bool isDerivable(NodeID src, NodeID dst, Label lbl);
+    //@}
+
     /// stat
     void dumpStat();
     virtual void countSumEdges();
 
-    static void timer()
-    {
-        sleep(CFLOpt::timeOut);
-        assert(false && "Time out!!");
-    }
+    u64_t getNumOfChecks() const override
+    { return stat->checks; }
+
+    /// Whether the items of the solver are processed with rule probes
+    virtual bool canProfileRules() const
+    { return true; }
+
+    /// Whether the solver stores its edges in the backend selected by -flat-data
+    virtual bool canUseFlatData() const
+    { return true; }
 
     /// summarizations via production rules
     //@{
-    Set<Label> unarySumm(Label lty) override;
-    Set<Label> binarySumm(Label lty, Label rty) override;
+    LabelSet unarySumm(Label lty) override;
+    LabelSet binarySumm(Label lty, Label rty) override;
+    /// via the compiled rule tables, used by the solvers where they are measured to be faster
+    LabelSet compiledUnarySumm(Label lty);
+    LabelSet compiledBinarySumm(Label lty, Label rty);
+    //@}
+
+    void processCFLItem(CFLItem item) override;
+    void processSetItem(NodeID src, const NodeBS& dstSet, Label ty) override;
+
+    /// Item processing, instantiated with rule probes only when profiling
+    //@{
+    template<bool Profiled>
+    void procItem(CFLItem item);
+    template<bool Profiled>
+    void procSetItem(NodeID src, const NodeBS& dstSet, Label ty);
     //@}
 
     /// CFL data methods with UCFL options
@@ -92,6 +199,131 @@ public:
 };
 
 
+/*!
+ * Multi-threaded standard CFL-reachability.
+ * The CFL data is sharded by node, each shard guarded by its own lock, and items are distributed over per-thread
+ * deques with work stealing. An item is processed only after both directions of its edge are stored, so that no
+ * derivation is lost between concurrently processed items sharing a node.
+ */
+class ParStdCFL : public StdCFL
+{
+public:
+    struct Shard
+    {
+        std::mutex mtx;
+        CFLData data;
+    };
+
+    struct ThreadQueue
+    {
+        std::mutex mtx;
+        std::deque<CFLItem> items;
+        u64_t checks;
+        std::vector<CFLItem> derived;   // edges derived under a shard lock, added after releasing it
+
+        ThreadQueue() : checks(0)
+        {}
+    };
+
+protected:
+    u32_t numOfThreads;
+    std::vector<Shard> shards;
+    std::vector<ThreadQueue> queues;
+    std::atomic<u64_t> numOfPendingItems;
+
+public:
+    ParStdCFL(std::string& _grammarName, std::string& _graphName);
+
+    void solve() override;
+
+    bool canProfileRules() const override
+    { return false; }
+
+    /// A flat table per shard would be sized by the largest node ID of all shards
+    bool canUseFlatData() const override
+    { return false; }
+
+    /// Edges and items are spread over shards and thread queues while solving
+    bool canCheckpoint() const override
+    { return false; }
+
+protected:
+    inline Shard& getShard(NodeID id)
+    { return shards[id & (shards.size() - 1)]; }
+
+    void distributeData();
+    void collectData();
+    void runWorker(u32_t tid);
+    bool popItem(u32_t tid, CFLItem& item);
+    void pushItem(u32_t tid, const CFLItem& item);
+    void processParItem(u32_t tid, const CFLItem& item);
+    bool addParEdge(u32_t tid, NodeID src, NodeID dst, Label lbl);
+};
+
+
+/*!
+ * Demand-driven standard CFL-reachability, only edges needed by count-symbol queries are derived.
+ * A demand (X, n) asks for X-edges leaving n (forward, from sources) or entering n (backward, to sinks).
+ * Terminal edges are kept aside and moved into the CFL data when demanded, and an edge of X ::= Y Z is
+ * derived only if X is demanded at its end, which in turn demands Y there and Z at the ends of Y-edges.
+ */
+class DemandCFL : public StdCFL
+{
+public:
+    typedef std::pair<CFGSymbTy, NodeID> Demand;
+
+protected:
+    bool backward;
+    std::string queryFName;
+    NodeBS queryNodes;
+    /// Demanded nodes of each symbol, and demands to be processed
+    Map<CFGSymbTy, NodeBS> demands;
+    FIFOWorkList<Demand> demandList;
+
+public:
+    DemandCFL(std::string& _grammarName, std::string& _graphName, std::string _queryFName, bool _backward);
+
+    void initSolver() override;
+    void solve() override;
+    void processCFLItem(CFLItem item) override;
+    void countSumEdges() override;
+
+    bool canProfileRules() const override
+    { return false; }
+
+    /// Edges are derived on demand, so there is no fixpoint to be saved
+    std::string getStateKind() const override
+    { return ""; }
+
+protected:
+    void addInputEdge(NodeID src, NodeID dst, Label lbl) override;
+    void readQueryNodes();
+
+    /// Demands
+    //@{
+    inline bool isDemanded(CFGSymbTy symb, NodeID node)
+    {
+        auto it = demands.find(symb);
+        return it != demands.end() && it->second.test(node);
+    }
+
+    inline bool isTerminal(CFGSymbTy symb)
+    {
+        return !grammar()->getEmptyRules().count(symb) && grammar()->getUnaryRhs(symb).empty()
+               && grammar()->getBinaryRhs(symb).empty();
+    }
+
+    void demand(CFGSymbTy symb, NodeID node);
+    void processDemand(const Demand& dmd);
+    //@}
+
+    /// Add a derived edge whose label is demanded at its query end
+    void addDemandedEdge(NodeID src, NodeID dst, Label lbl);
+    void processForward(const CFLItem& item);
+    void processBackward(const CFLItem& item);
+};
+
+
 /*!
  *  POCR solver
  */
@@ -113,6 +345,8 @@ public:
     void procPrimaryItem(CFLItem item);
     bool pushIntoWorklist(NodeID src, NodeID dst, Label ty, bool isPrimary = true) override;
     void processCFLItem(CFLItem item) override;
+    template<bool Profiled>
+    void procItem(CFLItem item);
     void checkPtree(Label newLbl, TreeNode* src, NodeID dst);
     void checkStree(Label newLbl, NodeID src, TreeNode* dst);
 
@@ -125,6 +359,15 @@ public:
     bool updateTrEdge(char lbl, NodeID px, TreeNode* py, NodeID sx, TreeNode* sy);
 
     void countSumEdges() override;
+
+    /// Solver states with the spanning trees
+    //@{
+    std::string getStateKind() const override
+    { return "pocr"; }
+
+    void saveState(StateWriter& writer) override;
+    void loadState(StateReader& reader) override;
+    //@}
 };
 
 
@@ -168,6 +411,8 @@ public:
     virtual void procPrimaryItem(CFLItem item);
     bool pushIntoWorklist(NodeID src, NodeID dst, Label ty, bool isPrimary = true) override;
     void processCFLItem(CFLItem item) override;
+    template<bool Profiled>
+    void procItem(CFLItem item);
     void checkPreds(Label newLbl, ECGNode* src, NodeID dst);
     void checkSuccs(Label newLbl, NodeID src, ECGNode* dst);
 
@@ -175,17 +420,29 @@ public:
     { return item.isPrimary(); }
 
     void countSumEdges() override;
+
+    /// Solver states with the ECGs
+    //@{
+    std::string getStateKind() const override
+    { return "focr"; }
+
+    void saveState(StateWriter& writer) override;
+    void loadState(StateReader& reader) override;
+    //@}
 };
 
 
 class TRFocrCFL : public FocrCFL
 {
 protected:
-    CFLData secondaryData;
+    CFLData* secondaryData;
 
 public:
     TRFocrCFL(std::string& _grammarName, std::string& _graphName) : FocrCFL(_grammarName, _graphName)
-    {}
+    { secondaryData = CFLData::createCFLData(); }
+
+    ~TRFocrCFL() override
+    { delete secondaryData; }
 
     /// UCFL methods
     void procPrimaryItem(CFLItem item) override;
@@ -193,6 +450,10 @@ public:
     NodeBS checkAndAddEdges(const NodeBS& srcSet, NodeID dst, Label lbl) override;
 
     void countSumEdges() override;
+
+    /// Secondary edges are not saved
+    std::string getStateKind() const override
+    { return ""; }
 };
 
 
@@ -202,16 +463,25 @@ public:
 class TRCFL : public StdCFL
 {
 protected:
-    CFLData secondaryData;
+    CFLData* secondaryData;
 
 public:
     TRCFL(std::string& _grammarName, std::string& _graphName) : StdCFL(_grammarName, _graphName)
-    {}
+    { secondaryData = CFLData::createCFLData(); }
+
+    ~TRCFL() override
+    { delete secondaryData; }
 
     /// UCFL methods
     bool pushIntoWorklist(NodeID src, NodeID dst, Label ty, bool isPrimary = true) override;
     void processCFLItem(CFLItem item) override;
 //    void checkPreds(Label newLbl, ECGNode* src, NodeID dst);
+
+    LabelSet unarySumm(Label lty) override
+    { return compiledUnarySumm(lty); }
+
+    LabelSet binarySumm(Label lty, Label rty) override
+    { return compiledBinarySumm(lty, rty); }
 //    void checkSuccs(Label newLbl, NodeID src, ECGNode* dst);
 
     NodeBS computeDiffEdges(NodeID src, const NodeBS& dstSet, Label lbl);
@@ -221,6 +491,13 @@ public:
     { return item.isPrimary(); }
 
     void countSumEdges() override;
+
+    bool canProfileRules() const override
+    { return false; }
+
+    /// Secondary edges are not saved
+    std::string getStateKind() const override
+    { return ""; }
 };
 
 }
@@ -7,6 +7,7 @@
 
 #include "SVF-LLVM/BasicTypes.h"
 #include "SVFIR/SVFType.h"
+#include "StatSink.h"
 
 namespace SVF
 {
@@ -25,14 +26,20 @@ public:
 
     /// num counters
     u32_t numOfIteration;
-    u32_t checks;
-    u32_t numOfSumEdges;
-    u32_t numOfCountEdges;
+    u64_t checks;
+    u64_t numOfSumEdges;
+    u64_t numOfCountEdges;
     u32_t numOfNodes;
     u32_t numOfEdges;
 
     /// time counters
     double timeOfSolving;
+    double wallTimeOfSolving;       // only set by parallel solvers
+    double timeOfLoadingState;      // only set when resuming from a saved state
+    double timeOfBaseSolving;       // solving time of the saved state
+    double timeOfParsing;           // reading the grammar and the input graph
+    double timeOfInit;              // initializing the solver, without reading the input graph
+    double timeOfCounting;          // counting summary edges
     double startTime;
     double endTime;
     double gsTime;
@@ -47,6 +54,9 @@ private:
     NUMStatMap PTNumStatMap;
     TIMEStatMap timeStatMap;
 
+    /// Structured statistics (-stat-format)
+    StatSink sink;
+
     /// Memory usage, in KB
     u32_t _vmrssUsageBefore;
     u32_t _vmrssUsageAfter;
@@ -61,7 +71,13 @@ public:
                          numOfCountEdges(0),
                          numOfNodes(0),
                          numOfEdges(0),
-                         timeOfSolving(0)
+                         timeOfSolving(0),
+                         wallTimeOfSolving(0),
+                         timeOfLoadingState(0),
+                         timeOfBaseSolving(0),
+                         timeOfParsing(0),
+                         timeOfInit(0),
+                         timeOfCounting(0)
     {
         startClk();
     };
@@ -84,6 +100,8 @@ public:
     void performStat();
     void graphStat();
     virtual void printStat(std::string str = "");
+    /// Phases, peak memory and input identity after the printed stats, for the json and csv formats
+    void writeStructuredStat();
     void writeSPairsIntoFile(std::string fName);
 };
 }
@@ -0,0 +1,79 @@
+//
+// Periodic checkpoints of solving
+//
+
+#ifndef POCR_SVF_CHECKPOINTER_H
+#define POCR_SVF_CHECKPOINTER_H
+
+#include "CFLData/BasicUtils.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace SVF
+{
+/*!
+ * Checkpoints of a solver every interval (-checkpoint, -checkpoint-interval).
+ * A thread marks a checkpoint as due, and the solver leaves solving at its next safe point to write it.
+ * The solver serializes its state into an in-memory image, which a writer thread writes while solving goes on,
+ * so that the solver is only stalled by the serialization. The image is memory of the solver process, so it
+ * is counted by -rss-budget. It goes to a temporary file first, which replaces the last checkpoint once complete.
+ */
+class Checkpointer
+{
+private:
+    std::string fname;
+    u32_t interval;
+    std::atomic<bool> due;
+
+    std::thread th;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopped;
+
+    /// The thread writing the last image into the file
+    std::thread writer;
+    std::atomic<bool> writing;
+    std::atomic<bool> writeFailed;
+    std::vector<char> image;
+    u32_t numOfCheckpoints;
+
+public:
+    Checkpointer(const std::string& _fname, u32_t _interval) : fname(_fname), interval(_interval), due(false),
+                                                               stopped(false), writing(false), writeFailed(false),
+                                                               numOfCheckpoints(0)
+    {}
+
+    ~Checkpointer()
+    { stop(); }
+
+    inline const std::atomic<bool>* getDue() const
+    { return &due; }
+
+    inline bool isDue() const
+    { return due.load(std::memory_order_relaxed); }
+
+    inline u32_t getNumOfCheckpoints() const
+    { return numOfCheckpoints; }
+
+    void start();
+    /// Stop marking checkpoints, and wait for the last one to be written
+    void stop();
+    /// Wait for the last checkpoint to be written, e.g., one written after stop()
+    inline void wait()
+    { waitWriter(true); }
+    /// Serialize a checkpoint with fillFn(image) and write it in the writer thread, skipped while the last one is
+    /// still being written
+    void write(const std::function<bool(std::vector<char>&)>& fillFn);
+
+private:
+    void run();
+    void writeImage();
+    /// Join the writer thread, false if it is still writing with !block
+    bool waitWriter(bool block);
+};
+
+}
+
+#endif //POCR_SVF_CHECKPOINTER_H
@@ -0,0 +1,112 @@
+//
+// Progress telemetry of solving
+//
+
+#ifndef POCR_SVF_PROGRESSSAMPLER_H
+#define POCR_SVF_PROGRESSSAMPLER_H
+
+#include "CFLData/BasicUtils.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace SVF
+{
+/*!
+ * Counters published by a solver for the progress sampler. The solver counts its items in plain fields
+ * and publishes them through relaxed atomics every publishInterval items, so that sampling costs it
+ * a branch per item.
+ */
+class SolverProgress
+{
+public:
+    static const u32_t publishInterval = 4096;
+    static const u32_t maxSymbols = 64;     // larger symbols are counted with symbol 0
+
+    /// Published counters, read by the sampler
+    //@{
+    std::atomic<u64_t> numOfItems;
+    std::atomic<u64_t> worklistSize;
+    std::atomic<u64_t> checks;
+    std::atomic<u64_t> itemsOfSymbols[maxSymbols];
+    //@}
+
+private:
+    u64_t items;
+    u64_t symbItems[maxSymbols];
+
+public:
+    SolverProgress() : numOfItems(0), worklistSize(0), checks(0), items(0)
+    {
+        for (u32_t i = 0; i < maxSymbols; ++i)
+        {
+            itemsOfSymbols[i] = 0;
+            symbItems[i] = 0;
+        }
+    }
+
+    /// Count a processed item, true if it is time to publish
+    inline bool countItem(CFGSymbTy symb)
+    {
+        symbItems[symb < maxSymbols ? symb : 0]++;
+        return ++items % publishInterval == 0;
+    }
+
+    inline void publish(u64_t _worklistSize, u64_t _checks)
+    {
+        numOfItems.store(items, std::memory_order_relaxed);
+        worklistSize.store(_worklistSize, std::memory_order_relaxed);
+        checks.store(_checks, std::memory_order_relaxed);
+        for (u32_t i = 0; i < maxSymbols; ++i)
+            itemsOfSymbols[i].store(symbItems[i], std::memory_order_relaxed);
+    }
+};
+
+
+/*!
+ * A thread printing the progress of a solver every interval (-progress) to stderr, as a line of text or,
+ * with -stat-format=json, a JSON record. The derived edges are the processed items and those in the worklist,
+ * and the most active labels are those of the most items processed in the interval.
+ */
+class ProgressSampler
+{
+private:
+    SolverProgress progress;
+    Map<CFGSymbTy, std::string> symbNames;
+    u32_t interval;
+
+    std::thread th;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopped;
+
+    /// Counters of the last record
+    //@{
+    double startTime;
+    double lastTime;
+    u64_t lastEdges;
+    u64_t lastSymbItems[SolverProgress::maxSymbols];
+    //@}
+
+public:
+    ProgressSampler(const Map<CFGSymbTy, std::string>& _symbNames, u32_t _interval);
+
+    ~ProgressSampler()
+    { stop(); }
+
+    inline SolverProgress* getProgress()
+    { return &progress; }
+
+    void start();
+    /// Stop sampling with a last record
+    void stop();
+
+private:
+    void run();
+    void sample();
+};
+
+}
+
+#endif //POCR_SVF_PROGRESSSAMPLER_H
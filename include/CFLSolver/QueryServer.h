@@ -0,0 +1,181 @@
+//
+// Serving reachability queries over a Unix socket
+//
+
+#ifndef POCR_SVF_QUERYSERVER_H
+#define POCR_SVF_QUERYSERVER_H
+
+#include "CFLData/SolverState.h"
+#include <atomic>
+
+namespace SVF
+{
+/*!
+ * Buffered binary channel over a connected socket, shared by the server and its clients
+ */
+class QueryChannel
+{
+private:
+    int fd;
+    std::vector<char> inBuf;
+    size_t inPos;
+    size_t inEnd;
+    std::string outBuf;
+
+public:
+    explicit QueryChannel(int _fd) : fd(_fd), inBuf(1 << 16), inPos(0), inEnd(0)
+    {}
+
+    inline int getFd() const
+    { return fd; }
+
+    /// False on the end of the stream or errors
+    bool readBytes(void* dst, size_t size);
+    bool flush();
+
+    /// Written bytes are buffered until flushed, so that a peer is never blocked while still sending its request
+    inline void writeBytes(const void* src, size_t size)
+    { outBuf.append((const char*) src, size); }
+
+    inline bool readU32(u32_t& val)
+    { return readBytes(&val, sizeof(val)); }
+
+    inline void writeU32(u32_t val)
+    { writeBytes(&val, sizeof(val)); }
+};
+
+
+/*!
+ * Answering point queries (is (u, v) an edge of symbol X) and row queries (all v with an X-edge (u, v))
+ * over the solved CFL data. The data is only read after solving, so connections are served by a pool of
+ * threads without locks.
+ *
+ * A request is three u32s (op, symbol, count) followed by the payload of the op, and a response is a u32
+ * status followed by the payload of the op. Symbol 0 stands for the default symbol of the server.
+ *   Point:     count (src, dst) pairs    ->  count bytes, 1 for edges
+ *   Row:       count srcs                ->  for each src, the number of dsts and the ascending dsts
+ *   Symbol:    count bytes of a name     ->  the symbol ID
+ *   Info:      -                         ->  the default symbol and the number of node IDs
+ *   Shutdown:  -                         ->  -
+ */
+class QueryServer
+{
+public:
+    enum OpTy
+    {
+        Point = 1,
+        Row,
+        Symbol,
+        Info,
+        Shutdown
+    };
+
+    enum StatusTy
+    {
+        Ok = 0,
+        UnknownSymbol,
+        BadRequest
+    };
+
+private:
+    CFLData* data;
+    /// Symbols whose edges are kept in spanning trees rather than in the data
+    Map<CFGSymbTy, HybridData*> treeMap;
+    /// A state file mapped by loadState, whose data and trees are read in place by the queries
+    //@{
+    StateReader* state;
+    std::vector<const char*> stateSuccs;    // the successor entries of each node in the data section, null for none
+    const char* stateDataEnd;
+    struct StateTrees
+    {
+        Map<NodeID, const char*> roots;     // each tree after its root ID
+        const char* end;
+    };
+    Map<CFGSymbTy, StateTrees> stateTrees;
+    //@}
+    Map<std::string, CFGSymbTy> symbols;
+    Set<CFGSymbTy> symbIds;
+    CFGSymbTy defaultSymb;
+    NodeID numOfNodes;
+
+    int listenFd;
+    std::atomic<bool> stopped;
+
+public:
+    QueryServer() : data(nullptr), state(nullptr), stateDataEnd(nullptr), defaultSymb(0), numOfNodes(0), listenFd(-1),
+                    stopped(false)
+    {}
+
+    ~QueryServer();
+
+    /// Data of a solver, which is kept by the solver
+    //@{
+    void setData(CFLData* _data, const NodeBS& nodes);
+    void addTrees(CFGSymbTy symb, HybridData* trees);
+    void addSymbols(const Map<CFGSymbTy, std::string>& symbMap);
+    //@}
+
+    /// Data of a state file written by -save-state, by a solver whose kind starts with kindPrefix.
+    /// The file stays mapped and only the positions of the nodes and trees are indexed, nothing is copied.
+    bool loadState(const std::string& fname, const std::string& kindPrefix);
+
+    /// False if there is no symbol of the name
+    bool setDefaultSymbol(const std::string& name);
+
+    /// Queries, safe for concurrent readers
+    //@{
+    bool hasEdge(NodeID src, NodeID dst, CFGSymbTy symb) const;
+    void getDsts(NodeID src, CFGSymbTy symb, NodeBS& dsts) const;
+    //@}
+
+    /// Serve until a shutdown request, false if the socket cannot be opened
+    bool serve(const std::string& sockPath, u32_t numOfThreads);
+
+private:
+    /// Queries over the mapped state
+    //@{
+    bool hasStateEdge(NodeID src, NodeID dst, CFGSymbTy symb) const;
+    void getStateDsts(NodeID src, CFGSymbTy symb, NodeBS& dsts) const;
+    //@}
+
+    void acceptConnections();
+    void serveConnection(QueryChannel& channel);
+};
+
+
+/*!
+ * Client of a query server
+ */
+class QueryClient
+{
+private:
+    QueryChannel* channel;
+
+public:
+    QueryClient() : channel(nullptr)
+    {}
+
+    ~QueryClient()
+    { close(); }
+
+    bool connect(const std::string& sockPath);
+    void close();
+
+    /// Requests, false on connection errors or a non-ok status
+    //@{
+    bool info(CFGSymbTy& defaultSymb, NodeID& numOfNodes);
+    bool lookupSymbol(const std::string& name, CFGSymbTy& symb);
+    bool queryPoints(CFGSymbTy symb, const std::vector<std::pair<NodeID, NodeID>>& pairs, std::vector<u8_t>& results);
+    bool queryRows(CFGSymbTy symb, const std::vector<NodeID>& srcs, std::vector<std::vector<NodeID>>& rows);
+    bool shutdown();
+    //@}
+
+private:
+    void sendHeader(u32_t op, CFGSymbTy symb, u32_t count);
+    /// Flush the request and read the status of its response
+    bool receiveStatus();
+};
+
+}
+
+#endif //POCR_SVF_QUERYSERVER_H
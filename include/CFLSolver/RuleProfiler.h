@@ -0,0 +1,135 @@
+//
+// Per-production profiling of CFL solvers
+//
+
+#ifndef POCR_SVF_RULEPROFILER_H
+#define POCR_SVF_RULEPROFILER_H
+
+#include "CFLBase.h"
+#include "CFLData/CFG.h"
+#include <chrono>
+
+namespace SVF
+{
+/*!
+ * Counters of each production X ::= Y Z (Z is 0 for X ::= Y), kept in a table indexed by the symbols.
+ * An application of a production is the combination of one item with the edges of one rhs label.
+ * Its derivations are the candidate edges checked, of which the new edges are pushed into the worklist
+ * and the others are redundant.
+ */
+class RuleProfiler
+{
+public:
+    struct RuleStat
+    {
+        u64_t firings;
+        u64_t derivations;
+        u64_t newEdges;
+        u64_t nanoSecs;
+
+        RuleStat() : firings(0), derivations(0), newEdges(0), nanoSecs(0)
+        {}
+    };
+
+private:
+    CFG* grammar;
+    u32_t numOfSlots;
+    std::vector<RuleStat> ruleStats;
+
+    /// Counters of the solver the derivations and new edges are taken from
+    //@{
+    const u64_t* checks;
+    const CFLWorkList* worklist;
+    //@}
+
+public:
+    RuleProfiler(CFG* _grammar, const u64_t* _checks, const CFLWorkList* _worklist);
+
+    inline RuleStat& getRuleStat(CFGSymbTy lhs, CFGSymbTy lRhs, CFGSymbTy rRhs = 0)
+    { return ruleStats[(lhs * numOfSlots + lRhs) * numOfSlots + rRhs]; }
+
+    inline u64_t getChecks() const
+    { return *checks; }
+
+    /// Items are only pushed while a production is applied, so the growth of the worklist is the new edges
+    inline u64_t getWorklistSize() const
+    { return worklist->size(); }
+
+    /// Productions ranked by time, and all of them as CSV
+    //@{
+    void printReport(double solvingTime);
+    void writeCSV(const std::string& fname);
+    //@}
+
+private:
+    std::string getRuleString(CFGSymbTy lhs, CFGSymbTy lRhs, CFGSymbTy rRhs);
+    void getFiredRules(std::vector<u32_t>& rules);
+};
+
+
+/*!
+ * Measuring one application of a production, from its construction to its destruction.
+ * Solvers instantiate their item processing with Enabled false when not profiling, for which the probe is empty.
+ */
+template<bool Enabled>
+class RuleProbe
+{
+public:
+    RuleProbe(RuleProfiler* profiler, CFGSymbTy lhs, CFGSymbTy lRhs, CFGSymbTy rRhs = 0)
+    {}
+
+    /// Derivations not checked by checkAndAddEdge(s), e.g. in spanning trees
+    inline void addDerivations(u64_t num)
+    {}
+
+    /// New edges not pushed into the worklist, e.g. by set-at-a-time propagation
+    inline void addNewEdges(u64_t num)
+    {}
+
+    /// Pushed items of edges that are not new
+    inline void discountNewEdges(u64_t num)
+    {}
+};
+
+
+template<>
+class RuleProbe<true>
+{
+private:
+    RuleProfiler* profiler;
+    RuleProfiler::RuleStat& ruleStat;
+    u64_t checks;
+    u64_t items;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    RuleProbe(RuleProfiler* _profiler, CFGSymbTy lhs, CFGSymbTy lRhs, CFGSymbTy rRhs = 0)
+            : profiler(_profiler),
+              ruleStat(_profiler->getRuleStat(lhs, lRhs, rRhs)),
+              checks(_profiler->getChecks()),
+              items(_profiler->getWorklistSize()),
+              start(std::chrono::steady_clock::now())
+    {}
+
+    ~RuleProbe()
+    {
+        ruleStat.nanoSecs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        ruleStat.firings++;
+        ruleStat.derivations += profiler->getChecks() - checks;
+        ruleStat.newEdges += profiler->getWorklistSize() - items;
+    }
+
+    inline void addDerivations(u64_t num)
+    { ruleStat.derivations += num; }
+
+    inline void addNewEdges(u64_t num)
+    { ruleStat.newEdges += num; }
+
+    inline void discountNewEdges(u64_t num)
+    { ruleStat.newEdges -= num; }
+};
+
+}
+
+#endif //POCR_SVF_RULEPROFILER_H
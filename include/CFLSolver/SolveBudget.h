@@ -0,0 +1,65 @@
+//
+// Wall-clock and memory budgets of solving
+//
+
+#ifndef POCR_SVF_SOLVEBUDGET_H
+#define POCR_SVF_SOLVEBUDGET_H
+
+#include "CFLData/BasicUtils.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace SVF
+{
+/*!
+ * A thread watching the budgets of solving (-time-budget, -rss-budget) every second. Once a budget runs out,
+ * the solver stops at its next safe point, i.e., between items or rounds, and finalizes a partial result.
+ */
+class SolveBudget
+{
+public:
+    enum ExceededTy
+    {
+        None,
+        Time,
+        Memory
+    };
+
+private:
+    u32_t timeBudget;       // in second, 0 for no budget
+    u32_t rssBudget;        // in MB, 0 for no budget
+    std::atomic<u32_t> exceeded;
+
+    std::thread th;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopped;
+
+public:
+    SolveBudget(u32_t _timeBudget, u32_t _rssBudget) : timeBudget(_timeBudget), rssBudget(_rssBudget),
+                                                       exceeded(None), stopped(false)
+    {}
+
+    ~SolveBudget()
+    { stop(); }
+
+    inline bool isExceeded() const
+    { return exceeded.load(std::memory_order_relaxed) != None; }
+
+    inline ExceededTy getExceeded() const
+    { return (ExceededTy) exceeded.load(std::memory_order_relaxed); }
+
+    void start();
+    void stop();
+    /// Why solving stopped, for the users
+    std::string getReason() const;
+
+private:
+    void run();
+};
+
+}
+
+#endif //POCR_SVF_SOLVEBUDGET_H
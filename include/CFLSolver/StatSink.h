@@ -0,0 +1,74 @@
+//
+// Machine-readable statistics of analyses
+//
+
+#ifndef POCR_SVF_STATSINK_H
+#define POCR_SVF_STATSINK_H
+
+#include "CFLData/BasicUtils.h"
+#include "CFLOpt.h"
+
+namespace SVF
+{
+/*!
+ * Statistics written as JSON or CSV (-stat-format, -stat-file), kept as (section, name, value) entries in the
+ * order added. A JSON file is an object of sections, each an object of names, and a CSV file has a line per entry.
+ * Without -stat-file, they are written to stdout in place of the text statistics.
+ */
+class StatSink
+{
+public:
+    enum FormatTy
+    {
+        Text,
+        JSON,
+        CSV
+    };
+
+private:
+    struct Entry
+    {
+        std::string section;
+        std::string name;
+        std::string value;
+        bool isString;
+    };
+
+    std::vector<Entry> entries;
+
+    /// The command line of the tool, set before options are parsed
+    static std::string commandLine;
+
+public:
+    static FormatTy getFormat();
+
+    /// Whether text statistics are printed, i.e., structured ones are not written to stdout instead
+    static inline bool printsText()
+    { return getFormat() == Text || !CFLOpt::statFile().empty(); }
+
+    static void setCommandLine(int argc, char** argv);
+
+    /// Entries
+    //@{
+    void add(const std::string& section, const std::string& name, u64_t val);
+    void add(const std::string& section, const std::string& name, double val);
+    void add(const std::string& section, const std::string& name, const std::string& val);
+    //@}
+
+    /// The command line, and the path, size and content hash of each input file by its role
+    void addIdentity(const std::vector<std::pair<std::string, std::string>>& inputs);
+    /// Peak resident set size of the process
+    void addPeakMemory();
+
+    /// Write the entries in the format of -stat-format, nothing for text
+    void write();
+
+private:
+    static std::string escape(const std::string& str);
+    void writeJSON(std::ostream& out);
+    void writeCSV(std::ostream& out);
+};
+
+}
+
+#endif //POCR_SVF_STATSINK_H
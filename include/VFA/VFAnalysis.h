@@ -14,6 +14,7 @@
 #include "IVFGFold.h"
 #include "IVFGInterDyck.h"
 #include "CFLData/ECG.h"
+#include "CFLSolver/QueryServer.h"
 
 namespace SVF
 {
@@ -72,6 +73,9 @@ public:
         delete interDyck;
     }
 
+    inline const std::string& getGraphName() const
+    { return graphName; }
+
     /// Graph operations
     //@{
     const inline IVFG* graph() const
@@ -90,10 +94,25 @@ public:
     virtual void finalize();
     virtual bool pushIntoWorklist(NodeID src, NodeID dst, Label ty);
 
-    Set<Label> unarySumm(Label lty) override
+    /// Solved states (-save-state) for querying without solving, the kind is empty for solvers without states
+    //@{
+    virtual std::string getStateKind() const
+    { return ""; }
+
+    virtual void saveState(StateWriter& writer);
+    //@}
+
+    /// Queries (-serve) of the solvers with states, valueflow by A is the default symbol
+    //@{
+    static Map<CFGSymbTy, std::string> getWordNames();
+    virtual void setQueryData(QueryServer& server);
+    void serveQueries(const std::string& sockPath);
+    //@}
+
+    LabelSet unarySumm(Label lty) override
     { return {}; }
 
-    Set<Label> binarySumm(Label lty, Label rty) override
+    LabelSet binarySumm(Label lty, Label rty) override
     { return {}; }
 
     bool checkAndAddEdge(NodeID src, NodeID dst, Label lbl) override;
@@ -109,13 +128,10 @@ public:
     }
 
     virtual void countSumEdges();
-    //@}
 
-    static void timer()
-    {
-        sleep(CFLOpt::timeOut);
-        assert(false && "Time out!!");
-    }
+    u64_t getNumOfChecks() const override
+    { return stat->checks; }
+    //@}
 
     /// Graph simplification
     //@{
@@ -139,12 +155,15 @@ public:
     StdVFA(std::string gName) : VFAnalysis(gName)
     {}
 
+    std::string getStateKind() const override
+    { return "vfa-std"; }
+
     void initSolver() override;
 
     /// CFLItem operations
     //@{
-    Set<Label> binarySumm(Label lty, Label rty) override;
-    Set<Label> unarySumm(Label lty) override;
+    LabelSet binarySumm(Label lty, Label rty) override;
+    LabelSet unarySumm(Label lty) override;
     //@}
 };
 
@@ -164,6 +183,12 @@ public:
     PocrVFA(std::string gName) : VFAnalysis(gName)
     {}
 
+    std::string getStateKind() const override
+    { return "vfa-pocr"; }
+
+    void saveState(StateWriter& writer) override;
+    void setQueryData(QueryServer& server) override;
+
     void initSolver() override;
     void solve() override;
 
@@ -201,18 +226,20 @@ public:
 
 
 /*!
- * Graspan
+ * Graspan, rounds are solved in parallel with -threads=N
  */
 class GspanVFA : public StdVFA
 {
 protected:
     CFLData* _oldData;
+    u32_t numOfThreads;
 
 public:
     GspanVFA(std::string gName) : StdVFA(gName), _oldData(nullptr)
     {
         if (!_oldData)
-            _oldData = new CFLData();
+            _oldData = CFLData::createCFLData();
+        numOfThreads = getNumOfThreads(CFLOpt::threads());
     }
 
     CFLData* oldData()
@@ -220,8 +247,18 @@ public:
         return _oldData;
     }
 
+    std::string getStateKind() const override
+    { return ""; }
+
     void initSolver() override;
     void solve() override;
+    /// One round, sources are summarized in parallel into thread-local results and then merged in parallel
+    void solveInParallel();
+    /// Edges derived from src by joining old and new edges
+    void summarize(NodeID src, CFLData::TypeMap& res, u64_t& checks);
+    /// Move new edges of src into old ones, and take the underived part of res as new edges
+    void update(NodeID src, CFLData::TypeMap& res);
+
     void countSumEdges() override;
 };
 
@@ -235,8 +272,11 @@ public:
     GRVFA(std::string gName) : StdVFA(gName)
     {}
 
-    Set<Label> binarySumm(Label lty, Label rty) override;
-    Set<Label> unarySumm(Label lty) override;
+    std::string getStateKind() const override
+    { return ""; }
+
+    LabelSet binarySumm(Label lty, Label rty) override;
+    LabelSet unarySumm(Label lty) override;
 };
 
 
@@ -249,8 +289,8 @@ public:
     GRGspanVFA(std::string gName) : GspanVFA(gName)
     {}
 
-    Set<Label> binarySumm(Label lty, Label rty) override;
-    Set<Label> unarySumm(Label lty) override;
+    LabelSet binarySumm(Label lty, Label rty) override;
+    LabelSet unarySumm(Label lty) override;
 };
 
 }
@@ -7,6 +7,7 @@
  *      Author: Yuxiang Lei
  */
 
+#include <fstream>
 #include <iomanip>
 #include "AA/AAStat.h"
 #include "AA/AliasAnalysis.h"
@@ -14,19 +15,27 @@
 using namespace SVF;
 
 
+/*!
+ * Printed stats are added to the structured ones, and printed only in the text format
+ */
 void AAStat::printStat(std::string statname)
 {
     std::cout.flags(std::ios::left);
     unsigned field_width = 20;
+    bool printsText = StatSink::printsText();
     for (TIMEStatMap::iterator it = timeStatMap.begin(), eit = timeStatMap.end(); it != eit; ++it)
     {
+        sink.add(strcmp(it->first, "VmrssInGB") ? "times" : "memory", it->first, it->second);
         // format out put with width 20 space
-        std::cout << it->first << "\t" << it->second << "\n";
+        if (printsText)
+            std::cout << it->first << "\t" << it->second << "\n";
     }
     for (NUMStatMap::iterator it = PTNumStatMap.begin(), eit = PTNumStatMap.end(); it != eit; ++it)
     {
+        sink.add("counters", it->first, it->second);
         // format out put with width 20 space
-        std::cout << it->first << "\t" << it->second << "\n";
+        if (printsText)
+            std::cout << it->first << "\t" << it->second << "\n";
     }
 
     std::cout.flush();
@@ -63,15 +72,53 @@ void AAStat::performStat()
     if (!CFLOpt::PStat())
         return;
 
+    double countStart = getClk();
     aa->countSumEdges();
+    timeOfCounting = (getClk() - countStart) / TIMEINTERVAL;
 
     timeStatMap["AnalysisTime"] = timeOfSolving;
     timeStatMap["VmrssInGB"] = (_vmrssUsageAfter - _vmrssUsageBefore) / 1024.0 / 1024.0;
     PTNumStatMap["#Checks"] = checks;
     PTNumStatMap["#SumEdges"] = numOfSumEdges - numOfEdges;
     PTNumStatMap["#SEdges"] = numOfSEdges;
+    if (aa->isPartial())
+        PTNumStatMap["Partial"] = 1;
+
+    /// the names are all built before being keyed, as the map keeps their pointers
+    roundTimeNames.clear();
+    for (u32_t i = 0; i < roundTimes.size(); ++i)
+        roundTimeNames.push_back("Round" + std::to_string(i + 1) + "Time");
+    for (u32_t i = 0; i < roundTimes.size(); ++i)
+        timeStatMap[roundTimeNames[i].c_str()] = roundTimes[i];
 
     printStat("CFL-reachability analysis Stats");
+    writeStructuredStat();
+
+    if (!CFLOpt::sPairsFName().empty())
+        writeSPairsIntoFile(CFLOpt::sPairsFName());
+}
+
+
+/*!
+ * Phases in seconds, simplification is split into its passes
+ */
+void AAStat::writeStructuredStat()
+{
+    if (StatSink::getFormat() == StatSink::Text)
+        return;
+
+    sink.add("phases", "parse", timeOfParsing);
+    sink.add("phases", "scc", sccTime);
+    sink.add("phases", "gf", gfTime);
+    sink.add("phases", "interdyck", interDyckTime);
+    sink.add("phases", "init", timeOfInit);
+    sink.add("phases", "solve", timeOfSolving);
+    sink.add("phases", "count", timeOfCounting);
+    sink.add("counters", "#Iterations", (u64_t) numOfIteration);
+    sink.addPeakMemory();
+    sink.add("input", "grammar", std::string("builtin:aa"));
+    sink.addIdentity({{"graph", aa->getGraphName()}});
+    sink.write();
 }
 
 
@@ -90,4 +137,24 @@ void AAStat::setMemUsageAfter()
     SVFUtil::getMemoryUsageKB(&vmrss, &vmsize);
     _vmrssUsageAfter = vmrss;
     _vmsizeUsageAfter = vmsize;
-}
\ No newline at end of file
+}
+
+
+void AAStat::writeSPairsIntoFile(std::string fName)
+{
+    std::ofstream outFile(fName, std::ios::out);
+    if (!outFile)
+    {
+        std::cout << "error opening file!";
+        return;
+    }
+
+    for (auto& it1 : sEdgeSet)
+    {
+        for (auto it2 : it1.second)
+            if (it2 != it1.first)
+                outFile << it1.first << '\t' << it2 << '\n';
+    }
+
+    outFile.close();
+}
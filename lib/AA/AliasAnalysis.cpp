@@ -15,16 +15,34 @@ using namespace SVFUtil;
 
 void AliasAnalysis::initialize()
 {
+    double parseStart = AAStat::getClk();
     setGraph(new PEG());
     graph()->readGraph(graphName);  // read a uni-directed graph
 
+    /// states are kept for the input nodes, which simplification changes
+    if (!CFLOpt::loadState().empty() || !CFLOpt::removedEdges().empty())
+    {
+        std::cout << "states are only loaded by the cfl tool or for serving queries (-serve)" << std::endl;
+        exit(UnsupportedExit);
+    }
+    /// queries are answered on the input nodes as well
+    if ((!CFLOpt::saveState().empty() || !CFLOpt::serve().empty())
+        && (getStateKind().empty() || CFLOpt::scc() || CFLOpt::gf() || CFLOpt::graphSimp() || CFLOpt::interDyck()))
+    {
+        std::cout << "solver states and queries are not supported with the given options" << std::endl;
+        exit(UnsupportedExit);
+    }
+
     stat = new AAStat(this);
     stat->setMemUsageBefore();
+    stat->timeOfParsing = (stat->getClk() - parseStart) / TIMEINTERVAL;
 
     /// Graph simplification
     simplifyGraph();
     /// initialize online solver
+    double initStart = stat->getClk();
     initSolver();
+    stat->timeOfInit = (stat->getClk() - initStart) / TIMEINTERVAL;
 }
 
 
@@ -35,6 +53,64 @@ void AliasAnalysis::finalize()
     dumpStat();
     if (!CFLOpt::outGraphFName().empty())
         graph()->writeGraph(CFLOpt::outGraphFName());
+    if (!CFLOpt::saveState().empty())
+    {
+        StateWriter writer(CFLOpt::saveState(), getStateKind());
+        saveState(writer);
+        if (!writer.good())
+            std::cout << "error writing " << CFLOpt::saveState() << std::endl;
+    }
+}
+
+
+Map<CFGSymbTy, std::string> AliasAnalysis::getWordNames()
+{
+    static const char* const wordNames[] = {"a", "abar", "d", "dbar", "f", "fbar", "M", "V", "DV", "A", "Abar", "FV"};
+    Map<CFGSymbTy, std::string> symbols;
+    for (CFGSymbTy word = 0; word < sizeof(wordNames) / sizeof(wordNames[0]); ++word)
+        symbols[word + 1] = wordNames[word];
+    return symbols;
+}
+
+
+/*!
+ * Symbols are named by the words, and the summary edges counted by dumpStat are saved with the others
+ */
+void AliasAnalysis::saveState(StateWriter& writer)
+{
+    writer.beginSection(StateWriter::Symbols);
+    writer.writeSymbols(getWordNames());
+    writer.endSection();
+
+    NodeBS nodes;
+    for (auto it = graph()->begin(); it != graph()->end(); ++it)
+        nodes.set(it->first);
+    writer.beginSection(StateWriter::Nodes);
+    writer.writeNodeBS(nodes);
+    writer.endSection();
+
+    writer.beginSection(StateWriter::Data);
+    writer.writeData(*cflData());
+    writer.endSection();
+}
+
+
+void AliasAnalysis::setQueryData(QueryServer& server)
+{
+    NodeBS nodes;
+    for (auto it = graph()->begin(); it != graph()->end(); ++it)
+        nodes.set(it->first);
+    server.setData(cflData(), nodes);
+    server.addSymbols(getWordNames());
+    server.setDefaultSymbol("V");
+}
+
+
+void AliasAnalysis::serveQueries(const std::string& sockPath)
+{
+    QueryServer server;
+    setQueryData(server);
+    server.serve(sockPath, getNumOfThreads(CFLOpt::serveThreads()));
 }
 
 
@@ -51,7 +127,16 @@ void AliasAnalysis::analyze()
 {
     initialize();
 
-    std::thread th(AliasAnalysis::timer);     // timer thread
+    SolveBudget budget(CFLOpt::timeBudget(), CFLOpt::rssBudget());
+    setBudget(&budget);
+    budget.start();
+    ProgressSampler* sampler = nullptr;
+    if (CFLOpt::progress())
+    {
+        sampler = new ProgressSampler(getWordNames(), CFLOpt::progress());
+        setProgress(sampler->getProgress());
+        sampler->start();
+    }
 
     // Start solving
     double propStart = stat->getClk();
@@ -62,17 +147,27 @@ void AliasAnalysis::analyze()
         reanalyze = false;
         if (CFLOpt::solveCFL())
             solve();
-    } while (reanalyze);
+    } while (reanalyze && !isStopped());
 
     double propEnd = stat->getClk();
     stat->timeOfSolving += (propEnd - propStart) / TIMEINTERVAL;
 
+    if (sampler)
+    {
+        publishProgress();
+        sampler->stop();
+        setProgress(nullptr);
+        delete sampler;
+    }
+
+    budget.stop();
+    setBudget(nullptr);
+    partial = budget.isExceeded();
+    if (partial)
+        std::cout << "solving stopped as " << budget.getReason() << ", the result is partial" << std::endl;
 
     // Finalize the analysis
     finalize();
-
-    pthread_cancel(th.native_handle());     // kill timer
-    th.join();
 }
 
 
@@ -109,14 +204,20 @@ NodeBS AliasAnalysis::checkAndAddEdges(const NodeBS& srcSet, NodeID dst, Label l
 void AliasAnalysis::countSumEdges()
 {
     stat->numOfSumEdges = 0;
+    stat->sEdgeSet.clear();
+    bool collectsSPairs = !CFLOpt::sPairsFName().empty();
 
-    for (auto iter1 = cflData()->begin(); iter1 != cflData()->end(); ++iter1)
+    for (NodeID src : cflData()->getSuccKeys())
     {
-        for (auto& iter2 : iter1->second)
+        for (auto& iter2 : cflData()->getSuccs(src))
         {
             stat->numOfSumEdges += iter2.second.count();
             if (iter2.first.first == V)
+            {
                 stat->numOfSEdges += iter2.second.count();
+                if (collectsSPairs)
+                    stat->sEdgeSet[src] |= iter2.second;
+            }
         }
     }
 }
@@ -124,7 +225,7 @@ void AliasAnalysis::countSumEdges()
 
 /// ------------------- Std AA Methods ----------------------
 
-Set<Label> StdAA::binarySumm(Label lty, Label rty)
+LabelSet StdAA::binarySumm(Label lty, Label rty)
 {
     u32_t lWord = lty.first;
     u32_t rWord = rty.first;
@@ -154,7 +255,7 @@ Set<Label> StdAA::binarySumm(Label lty, Label rty)
 }
 
 
-Set<Label> StdAA::unarySumm(Label lty)
+LabelSet StdAA::unarySumm(Label lty)
 {
     u32_t lWord = lty.first;
     if (lWord == M)
@@ -6,7 +6,7 @@
 
 using namespace SVF;
 
-Set<Label> GRAA::binarySumm(Label lty, Label rty)
+LabelSet GRAA::binarySumm(Label lty, Label rty)
 {
     char lWord = lty.first;
     char rWord = rty.first;
@@ -32,7 +32,7 @@ Set<Label> GRAA::binarySumm(Label lty, Label rty)
 }
 
 
-Set<Label> GRGspanAA::binarySumm(Label lty, Label rty)
+LabelSet GRGspanAA::binarySumm(Label lty, Label rty)
 {
     char lWord = lty.first;
     char rWord = rty.first;
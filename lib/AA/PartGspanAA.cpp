@@ -0,0 +1,422 @@
+//
+// Out-of-core Graspan alias analysis
+//
+
+
+#include "AA/AliasAnalysis.h"
+#include <bitset>
+#include <chrono>
+#include <climits>
+#include <tuple>
+#include <cstdlib>
+
+using namespace SVF;
+
+
+PartGspanAA::PartGspanAA(std::string gName) : GspanAA(gName), numOfSessions(0)
+{
+    budget = (u64_t) CFLOpt::memBudget() << 20;
+    std::string dirTemplate = CFLOpt::partDir() + "/pocr-part-XXXXXX";
+    std::vector<char> dirName(dirTemplate.begin(), dirTemplate.end());
+    dirName.push_back('\0');
+    if (!mkdtemp(dirName.data()))
+    {
+        std::cout << "error creating a partition directory under " << CFLOpt::partDir() << std::endl;
+        exit(1);
+    }
+    partDir = dirName.data();
+}
+
+
+PartGspanAA::~PartGspanAA()
+{
+    removePartitions();
+}
+
+
+void PartGspanAA::finalize()
+{
+    GspanAA::finalize();
+    removePartitions();
+}
+
+
+void PartGspanAA::removePartitions()
+{
+    for (u32_t p = 0; p < partitions.size(); ++p)
+        std::remove(partFileName(p).c_str());
+    partitions.clear();
+    rmdir(partDir.c_str());
+}
+
+
+/*!
+ * Initial edges are streamed into the partition files, so that they are never all in memory.
+ * A first pass estimates the size of the edges of each src and cuts the nodes into intervals of about a quarter
+ * of the budget, so that two partitions and the edges derived from them fit in the budget.
+ * A second pass appends the edges to their partitions, which are then merged one at a time.
+ */
+void PartGspanAA::initSolver()
+{
+    /// number of edges and symbols seen of each src, the symbols approximating its number of segments
+    std::map<NodeID, std::pair<u64_t, u32_t>> srcEdges;
+    forEachInitialEdge([&srcEdges](NodeID src, NodeID, Label lbl)
+    {
+        std::pair<u64_t, u32_t>& counts = srcEdges[src];
+        counts.first++;
+        counts.second |= 1U << (lbl.first & 31);
+    });
+
+    u64_t target = std::max<u64_t>(budget / 4, 1);
+    u64_t size = 0;
+    for (auto it = srcEdges.begin(); it != srcEdges.end();)
+    {
+        size += sizeof(Segment) * std::bitset<32>(it->second.second).count() + 8 * it->second.first;
+        if (++it != srcEdges.end() && size < target)
+            continue;
+
+        Partition part;
+        part.lo = partitions.empty() ? 0 : partitions.back().hi;
+        part.hi = it != srcEdges.end() ? it->first : UINT_MAX;
+        part.size = size;
+        part.lastModified = 0;
+        partOfLo[part.lo] = partitions.size();
+        partitions.push_back(part);
+        size = 0;
+    }
+    srcEdges.clear();
+    lastSession.assign(partitions.size(), std::vector<u32_t>(partitions.size(), 0));
+
+    /// records are buffered per partition up to the target in total
+    std::vector<std::vector<u32_t>> records(partitions.size());
+    u64_t bufferedSize = 0;
+    auto flush = [&]()
+    {
+        for (u32_t p = 0; p < partitions.size(); ++p)
+        {
+            appendPartition(p, records[p]);
+            std::vector<u32_t>().swap(records[p]);
+        }
+        bufferedSize = 0;
+    };
+    forEachInitialEdge([&](NodeID src, NodeID dst, Label lbl)
+    {
+        std::vector<u32_t>& words = records[partitionOf(src)];
+        words.insert(words.end(), {src, lbl.first, lbl.second, 0, 1, dst});
+        bufferedSize += 6 * sizeof(u32_t);
+        if (bufferedSize >= target)
+            flush();
+    });
+    flush();
+
+    for (u32_t p = 0; p < partitions.size(); ++p)
+    {
+        SegmentList segs;
+        readPartition(p, segs);
+        writePartition(p, segs);
+    }
+}
+
+
+/*!
+ * Partition pairs are scheduled until none of them has edges newer than its last session
+ */
+void PartGspanAA::solve()
+{
+    reanalyze = false;
+    bool changed = true;
+    while (changed && !isStopped())
+    {
+        changed = false;
+        auto start = std::chrono::steady_clock::now();
+        // partitions may be split during a pass
+        for (u32_t p = 0; p < partitions.size(); ++p)
+            for (u32_t q = partitions.size() == 1 ? p : p + 1; q < partitions.size(); ++q)
+            {
+                if (!needSession(p, q))
+                    continue;
+                runSession(p, q);
+                changed = true;
+            }
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        stat->roundTimes.push_back(duration.count());
+    }
+}
+
+
+bool PartGspanAA::needSession(u32_t p, u32_t q) const
+{
+    u32_t since = sessionOf(p, q);
+    return partitions[p].lastModified >= since || partitions[q].lastModified >= since;
+}
+
+
+/*!
+ * Edges of p and q stamped before their last session have been joined with each other,
+ * they are taken as old edges of Graspan and the others as new ones
+ */
+void PartGspanAA::runSession(u32_t p, u32_t q)
+{
+    u32_t stamp = ++numOfSessions;
+    u32_t since = sessionOf(p, q);
+    stat->numOfIteration++;
+
+    std::vector<SegmentList> segs(2);
+    readPartition(p, segs[0]);
+    if (q != p)
+        readPartition(q, segs[1]);
+
+    std::vector<NodeID> srcs;
+    for (SegmentList& list: segs)
+        for (Segment& seg: list)
+        {
+            CFLData* data = seg.stamp < since ? oldData() : cflData();
+            data->getSuccs(seg.src, seg.lbl) |= seg.dsts;
+            srcs.push_back(seg.src);
+        }
+    std::sort(srcs.begin(), srcs.end());
+    srcs.erase(std::unique(srcs.begin(), srcs.end()), srcs.end());
+    for (NodeID src: srcs)
+        for (auto& tyIter: cflData()->getSuccs(src))
+            tyIter.second.intersectWithComplement(oldData()->getSuccs(src, tyIter.first));
+
+    /// Graspan rounds on the loaded partitions, joins through unloaded nodes are left to other sessions.
+    /// All sources of a round are summarized before updating, since old edges of a session are never
+    /// joined with each other and so new edges of a node must not turn old before its predecessors see them.
+    u64_t checks = 0;
+    do
+    {
+        reanalyze = false;
+        std::vector<CFLData::TypeMap> results(srcs.size());
+        for (u32_t i = 0; i < srcs.size(); ++i)
+            summarize(srcs[i], results[i], checks);
+        for (u32_t i = 0; i < srcs.size(); ++i)
+            update(srcs[i], results[i]);
+    } while (reanalyze);
+    reanalyze = false;
+    stat->checks += checks;
+
+    /// What remains after removing the loaded edges is derived in this session
+    for (SegmentList& list: segs)
+        for (Segment& seg: list)
+            oldData()->getSuccs(seg.src, seg.lbl).intersectWithComplement(seg.dsts);
+    for (NodeID src: srcs)
+    {
+        u32_t part = partitionOf(src);
+        u32_t idx = part == p ? 0 : 1;
+        for (auto& tyIter: oldData()->getSuccs(src))
+        {
+            if (tyIter.second.empty())
+                continue;
+            segs[idx].push_back({src, tyIter.first, stamp, std::move(tyIter.second)});
+            partitions[part].lastModified = stamp;
+        }
+    }
+    oldData()->clear();
+    cflData()->clear();
+
+    setSessionOf(p, q, stamp + 1);
+    writePartition(p, segs[0]);
+    if (q != p)
+        writePartition(q, segs[1]);
+
+    /// Splitting appends partitions, so that the ones being scheduled keep their indices
+    u64_t target = std::max<u64_t>(budget / 4, 1);
+    if (partitions[p].size > target)
+        splitPartition(p, segs[0]);
+    if (q != p && partitions[q].size > target)
+        splitPartition(q, segs[1]);
+}
+
+
+/*!
+ * The upper half of p becomes a new partition,
+ * which inherits the sessions of p since its edges have taken part in them
+ */
+void PartGspanAA::splitPartition(u32_t p, SegmentList& segs)
+{
+    if (segs.empty() || segs.front().src == segs.back().src)
+        return;
+
+    u64_t half = partitions[p].size / 2;
+    u64_t size = estimateSize(segs.front());
+    u32_t mid = 1;
+    while (mid < segs.size() && (size < half || segs[mid].src == segs[mid - 1].src))
+        size += estimateSize(segs[mid++]);
+    if (mid == segs.size())
+        return;
+
+    u32_t n = partitions.size();
+    Partition part = partitions[p];
+    part.lo = segs[mid].src;
+    partitions[p].hi = part.lo;
+    partOfLo[part.lo] = n;
+    partitions.push_back(part);
+
+    for (std::vector<u32_t>& row: lastSession)
+        row.push_back(row[p]);
+    lastSession.push_back(lastSession[p]);
+    setSessionOf(p, n, 0);
+
+    SegmentList upper(std::make_move_iterator(segs.begin() + mid), std::make_move_iterator(segs.end()));
+    segs.erase(segs.begin() + mid, segs.end());
+    writePartition(p, segs);
+    writePartition(n, upper);
+}
+
+
+std::string PartGspanAA::partFileName(u32_t p) const
+{
+    return partDir + "/part" + std::to_string(p) + ".bin";
+}
+
+
+/*!
+ * Each segment is stored as src, label, stamp, number of dsts and the dsts
+ */
+void PartGspanAA::readPartition(u32_t p, SegmentList& segs) const
+{
+    std::ifstream in(partFileName(p), std::ios::binary);
+    if (!in)
+    {
+        std::cout << "error opening partition file " << partFileName(p) << std::endl;
+        exit(1);
+    }
+
+    u32_t header[5];
+    std::vector<NodeID> dsts;
+    bool complete = true;
+    while (in.read((char*) header, sizeof(header)))
+    {
+        dsts.resize(header[4]);
+        if (!in.read((char*) dsts.data(), dsts.size() * sizeof(NodeID)))
+        {
+            complete = false;
+            break;
+        }
+        segs.push_back({header[0], std::make_pair(header[1], header[2]), header[3], NodeBS()});
+        for (NodeID dst: dsts)
+            segs.back().dsts.set(dst);
+    }
+    /// the file ends right after a whole segment, i.e., only reading the next header fails and reads nothing
+    if (!complete || !in.eof() || in.gcount() != 0)
+    {
+        std::cout << "error reading partition file " << partFileName(p) << std::endl;
+        exit(1);
+    }
+}
+
+
+/*!
+ * Segments stamped before every session of p are merged, since they are old to all partition pairs
+ */
+void PartGspanAA::writePartition(u32_t p, SegmentList& segs)
+{
+    u32_t threshold = UINT_MAX;
+    for (u32_t r = 0; r < partitions.size(); ++r)
+        if (r != p || partitions.size() == 1)
+            threshold = std::min(threshold, sessionOf(p, r));
+    for (Segment& seg: segs)
+        if (seg.stamp < threshold)
+            seg.stamp = 0;
+
+    std::sort(segs.begin(), segs.end(), [](const Segment& lhs, const Segment& rhs)
+    {
+        return std::tie(lhs.src, lhs.lbl, lhs.stamp) < std::tie(rhs.src, rhs.lbl, rhs.stamp);
+    });
+    u32_t last = 0;
+    for (u32_t i = 1; i < segs.size(); ++i)
+    {
+        if (segs[i].src == segs[last].src && segs[i].lbl == segs[last].lbl && segs[i].stamp == segs[last].stamp)
+            segs[last].dsts |= segs[i].dsts;
+        else if (++last != i)
+            segs[last] = std::move(segs[i]);
+    }
+    if (!segs.empty())
+        segs.resize(last + 1);
+
+    std::ofstream out(partFileName(p), std::ios::binary | std::ios::trunc);
+    std::vector<NodeID> dsts;
+    partitions[p].size = 0;
+    for (const Segment& seg: segs)
+    {
+        dsts.clear();
+        for (NodeID dst: seg.dsts)
+            dsts.push_back(dst);
+        u32_t header[5] = {seg.src, seg.lbl.first, seg.lbl.second, seg.stamp, (u32_t) dsts.size()};
+        out.write((const char*) header, sizeof(header));
+        out.write((const char*) dsts.data(), dsts.size() * sizeof(NodeID));
+        partitions[p].size += estimateSize(seg);
+    }
+    if (!out)
+    {
+        std::cout << "error writing partition file " << partFileName(p) << std::endl;
+        exit(1);
+    }
+}
+
+
+void PartGspanAA::appendPartition(u32_t p, const std::vector<u32_t>& records) const
+{
+    if (records.empty())
+        return;
+
+    std::ofstream out(partFileName(p), std::ios::binary | std::ios::app);
+    out.write((const char*) records.data(), records.size() * sizeof(u32_t));
+    if (!out)
+    {
+        std::cout << "error writing partition file " << partFileName(p) << std::endl;
+        exit(1);
+    }
+}
+
+
+u32_t PartGspanAA::partitionOf(NodeID node) const
+{
+    auto it = partOfLo.upper_bound(node);
+    return (--it)->second;
+}
+
+
+u32_t PartGspanAA::sessionOf(u32_t p, u32_t q) const
+{
+    return lastSession[p][q];
+}
+
+
+void PartGspanAA::setSessionOf(u32_t p, u32_t q, u32_t session)
+{
+    lastSession[p][q] = session;
+    lastSession[q][p] = session;
+}
+
+
+/*!
+ * A rough in-memory size of a segment, assuming a sparse bit vector element per dst at worst
+ */
+u64_t PartGspanAA::estimateSize(const Segment& seg)
+{
+    return sizeof(Segment) + 8 * (u64_t) seg.dsts.count();
+}
+
+
+void PartGspanAA::countSumEdges()
+{
+    stat->numOfSumEdges = 0;
+    std::set<int> s = {M, V, DV, FV, A, Abar};
+    stat->sEdgeSet.clear();
+    bool collectsSPairs = !CFLOpt::sPairsFName().empty();
+
+    for (u32_t p = 0; p < partitions.size(); ++p)
+    {
+        SegmentList segs;
+        readPartition(p, segs);
+        for (const Segment& seg: segs)
+        {
+            if (s.find(seg.lbl.first) != s.end())
+                stat->numOfSumEdges += seg.dsts.count();
+            if (collectsSPairs && seg.lbl.first == V)
+                stat->sEdgeSet[seg.src] |= seg.dsts;
+        }
+    }
+}
@@ -44,9 +44,10 @@ void PocrAA::initSolver()
 
 void PocrAA::solve()
 {
-    while (!isWorklistEmpty())
+    while (!isWorklistEmpty() && !isStopped())
     {
         CFLItem item = popFromWorklist();
+        countItem(item.label());
         Label type = item.label();
         NodeID src = item.src();
         NodeID dst = item.dst();
@@ -156,29 +157,50 @@ void PocrAA::checkfEdges(NodeID src, NodeID dst)
 }
 
 
+/*!
+ * A-edges are kept in the trees rather than in the CFL data
+ */
+void PocrAA::saveState(StateWriter& writer)
+{
+    AliasAnalysis::saveState(writer);
+    writer.beginSection(StateWriter::Trees);
+    writer.write((CFGSymbTy) A);
+    writer.write((u32_t) 1);
+    writer.writeTrees(hybridData);
+    writer.endSection();
+}
+
+
+void PocrAA::setQueryData(QueryServer& server)
+{
+    AliasAnalysis::setQueryData(server);
+    server.addTrees(A, &hybridData);
+}
+
+
 void PocrAA::countSumEdges()
 {
     /// calculate checks
     stat->checks += hybridData.checks;
 
     /// calculate summary edges
-    for (auto& it1 : cflData()->getSuccMap())
+    for (NodeID src : cflData()->getSuccKeys())
     {
-        for (auto& it2 : it1.second)
+        for (auto& it2 : cflData()->getSuccs(src))
         {
             /// DV
             if (it2.first.first == d)
                 for (NodeID dTgt : it2.second)
                 {
                     setM(dTgt, dTgt);
-                    for (NodeID dst : cflData()->getSuccs(it1.first, Label(V, 0)))
+                    for (NodeID dst : cflData()->getSuccs(src, Label(V, 0)))
                         checkAndAddEdge(dTgt, dst, Label(DV, 0));
                 }
             /// FV
             if (it2.first.first == f)
                 for (NodeID fTgt : it2.second)
                 {
-                    for (NodeID dst : cflData()->getSuccs(it1.first, Label(V, 0)))
+                    for (NodeID dst : cflData()->getSuccs(src, Label(V, 0)))
                         checkAndAddEdge(fTgt, dst, Label(FV, it2.first.second));
                 }
         }
@@ -5,6 +5,13 @@
 #include "CFLData/BasicUtils.h"
 #include <fstream>
 #include <iostream>
+#include <atomic>
+#include <thread>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 namespace SVF
 {
@@ -69,4 +76,73 @@ std::string strip(std::string& str)
     return "";
 }
 
+
+
+bool mapFile(const std::string& fname, void*& base, size_t& length)
+{
+    int fd = ::open(fname.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    length = st.st_size;
+    base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED)
+    {
+        base = nullptr;
+        length = 0;
+        return false;
+    }
+    madvise(base, length, MADV_SEQUENTIAL);
+    return true;
+}
+
+
+u32_t getNumOfThreads(u32_t num)
+{
+    if (num)
+        return num;
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
+
+void parallelFor(u32_t numOfThreads, u32_t size, const std::function<void(u32_t, u32_t)>& body, u32_t grain)
+{
+    std::atomic<u32_t> next(0);
+
+    auto worker = [&](u32_t tid)
+    {
+        for (u32_t begin = next.fetch_add(grain); begin < size; begin = next.fetch_add(grain))
+        {
+            u32_t end = std::min(size, begin + grain);
+            for (u32_t idx = begin; idx < end; ++idx)
+                body(tid, idx);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (u32_t tid = 1; tid < numOfThreads; ++tid)
+        threads.emplace_back(worker, tid);
+    worker(0);
+    for (std::thread& th : threads)
+        th.join();
+}
+
+
+std::vector<std::string> splitList(const std::string& str, char sep)
+{
+    std::vector<std::string> items;
+    std::stringstream ss(str);
+    std::string item;
+    while (std::getline(ss, item, sep))
+        if (!item.empty())
+            items.push_back(item);
+    return items;
+}
+
 }
\ No newline at end of file
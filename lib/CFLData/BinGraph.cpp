@@ -0,0 +1,349 @@
+//
+// Binary graph files
+//
+
+#include "CFLData/BinGraph.h"
+#include <sys/mman.h>
+#include <cstring>
+#include <tuple>
+
+using namespace SVF;
+
+static const char binGraphMagic[8] = {'P', 'O', 'C', 'R', 'B', 'G', 'R', 'F'};
+
+
+bool BinGraph::isBinGraph(const std::string& fname)
+{
+    std::ifstream file(fname, std::ios::binary);
+    char magic[sizeof(binGraphMagic)];
+    return file.read(magic, sizeof(magic)) && memcmp(magic, binGraphMagic, sizeof(magic)) == 0;
+}
+
+
+bool BinGraph::open(const std::string& fname)
+{
+    close();
+
+    if (!mapFile(fname, base, length))
+        return false;
+    if (length < sizeof(Header))
+    {
+        close();
+        return false;
+    }
+
+    const Header* header = (const Header*) base;
+    const char* dict = (const char*) base + sizeof(Header);
+    /// sizes are checked by subtraction, as a crafted header may overflow their sum
+    u64_t rest = length - sizeof(Header);
+    if (memcmp(header->magic, binGraphMagic, sizeof(binGraphMagic)) != 0 || header->version != Version
+        || header->dictSize > rest || header->numOfEdges > (rest - header->dictSize) / sizeof(Record))
+    {
+        close();
+        return false;
+    }
+
+    /// each label is stored as its length followed by its characters
+    const char* pos = dict;
+    const char* dictEnd = dict + header->dictSize;
+    for (u32_t i = 0; i < header->numOfLabels; ++i)
+    {
+        u32_t len;
+        if ((u64_t) (dictEnd - pos) < sizeof(len))
+        {
+            close();
+            return false;
+        }
+        memcpy(&len, pos, sizeof(len));
+        pos += sizeof(len);
+        if ((u64_t) (dictEnd - pos) < len)
+        {
+            close();
+            return false;
+        }
+        labels.emplace_back(pos, len);
+        pos += len;
+    }
+    records = (const Record*) dictEnd;
+    numOfEdges = header->numOfEdges;
+
+    /// readers index their label tables by lbl
+    for (u64_t i = 0; i < numOfEdges; ++i)
+    {
+        if (records[i].lbl >= labels.size())
+        {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+
+bool BinGraph::load(const std::string& fname, u32_t numOfThreads)
+{
+    if (isBinGraph(fname))
+        return open(fname);
+    return parseText(fname, numOfThreads);
+}
+
+
+void BinGraph::close()
+{
+    if (base)
+        munmap(base, length);
+    base = nullptr;
+    length = 0;
+    labels.clear();
+    records = nullptr;
+    numOfEdges = 0;
+    parsedRecords.clear();
+    parsedRecords.shrink_to_fit();
+}
+
+
+namespace
+{
+/// Records and labels of a byte range of a text file, lbl of records indexes the local labels
+struct TextChunk
+{
+    std::vector<BinGraph::Record> recs;
+    std::vector<std::string> labels;
+    u64_t numOfLines = 0;
+    u64_t numOfSkipped = 0;
+    u64_t firstSkipped = 0;     // the line of the first skipped line in the chunk
+};
+
+inline bool isBlank(char c)
+{
+    return c == '\t' || c == ' ' || c == '\r';
+}
+
+inline const char* skipBlanks(const char* pos, const char* end)
+{
+    while (pos < end && isBlank(*pos))
+        ++pos;
+    return pos;
+}
+
+inline bool parseNum(const char*& pos, const char* end, u32_t& num)
+{
+    pos = skipBlanks(pos, end);
+    if (pos == end || *pos < '0' || *pos > '9')
+        return false;
+    u64_t val = 0;
+    while (pos < end && *pos >= '0' && *pos <= '9')
+    {
+        val = val * 10 + (*pos++ - '0');
+        /// numbers beyond u32_t would wrap into other nodes
+        if (val > UINT32_MAX)
+            return false;
+    }
+    num = val;
+    return true;
+}
+
+/*!
+ * Lines are "src dst label [idx]" separated by tabs or spaces, malformed lines are skipped and counted.
+ * Labels are few, so they are looked up linearly and only a new label allocates.
+ */
+void parseChunk(const char* pos, const char* end, TextChunk& chunk)
+{
+    u32_t lastLbl = 0;
+    while (pos < end)
+    {
+        const char* eol = (const char*) memchr(pos, '\n', end - pos);
+        if (!eol)
+            eol = end;
+
+        const char* line = pos;
+        bool parsed = false;
+        BinGraph::Record rec;
+        if (parseNum(pos, eol, rec.src) && parseNum(pos, eol, rec.dst))
+        {
+            const char* lblBegin = skipBlanks(pos, eol);
+            pos = lblBegin;
+            while (pos < eol && !isBlank(*pos))
+                ++pos;
+            size_t len = pos - lblBegin;
+            if (len)
+            {
+                if (lastLbl >= chunk.labels.size() || chunk.labels[lastLbl].size() != len
+                    || memcmp(chunk.labels[lastLbl].data(), lblBegin, len) != 0)
+                {
+                    for (lastLbl = 0; lastLbl < chunk.labels.size(); ++lastLbl)
+                        if (chunk.labels[lastLbl].size() == len && memcmp(chunk.labels[lastLbl].data(), lblBegin, len) == 0)
+                            break;
+                    if (lastLbl == chunk.labels.size())
+                        chunk.labels.emplace_back(lblBegin, len);
+                }
+                rec.lbl = lastLbl;
+                bool hasIdx = parseNum(pos, eol, rec.idx);
+                if (!hasIdx)
+                    rec.idx = 0;
+                /// an index overflowing u32_t stops parseNum at a digit
+                if (hasIdx || pos == eol || *pos < '0' || *pos > '9')
+                {
+                    chunk.recs.push_back(rec);
+                    parsed = true;
+                }
+            }
+        }
+        /// blank lines are not malformed
+        if (!parsed && skipBlanks(line, eol) != eol && !chunk.numOfSkipped++)
+            chunk.firstSkipped = chunk.numOfLines;
+        chunk.numOfLines++;
+        pos = eol + 1;
+    }
+}
+}
+
+
+/*!
+ * Chunks are cut at line ends and concatenated in order, so records keep the order of lines
+ */
+bool BinGraph::parseText(const std::string& fname, u32_t numOfThreads)
+{
+    close();
+
+    void* text = nullptr;
+    size_t size = 0;
+    /// an empty file fails like a missing one, as it is more likely a broken input than an empty graph
+    if (!mapFile(fname, text, size))
+        return false;
+    const char* begin = (const char*) text;
+    const char* end = begin + size;
+
+    /// more chunks than threads for balance, each chunk is at least 1MB
+    const size_t minChunkSize = 1 << 20;
+    u32_t numOfChunks = numOfThreads == 1 ? 1 : std::max<size_t>(1, std::min<size_t>(numOfThreads * 4, size / minChunkSize));
+    std::vector<const char*> bounds(numOfChunks + 1, end);
+    bounds[0] = begin;
+    for (u32_t i = 1; i < numOfChunks; ++i)
+    {
+        const char* pos = std::max(begin + size / numOfChunks * i, bounds[i - 1]);
+        const char* eol = (const char*) memchr(pos, '\n', end - pos);
+        bounds[i] = eol ? eol + 1 : end;
+    }
+
+    std::vector<TextChunk> chunks(numOfChunks);
+    parallelFor(numOfThreads, numOfChunks, [&](u32_t tid, u32_t i)
+    {
+        parseChunk(bounds[i], bounds[i + 1], chunks[i]);
+    }, 1);
+    munmap(text, size);
+
+    u64_t numOfSkipped = 0, firstSkipped = 0, numOfLines = 0;
+    for (TextChunk& chunk: chunks)
+    {
+        if (chunk.numOfSkipped && !numOfSkipped)
+            firstSkipped = numOfLines + chunk.firstSkipped + 1;
+        numOfSkipped += chunk.numOfSkipped;
+        numOfLines += chunk.numOfLines;
+    }
+    if (numOfSkipped)
+        std::cout << "skipped " << numOfSkipped << " malformed lines of " << fname << ", the first at line "
+                  << firstSkipped << std::endl;
+
+    /// merge chunk-local labels into the dictionary
+    Map<std::string, u32_t> lblIds;
+    u64_t total = 0;
+    for (TextChunk& chunk: chunks)
+    {
+        std::vector<u32_t> toGlobal;
+        for (const std::string& lbl: chunk.labels)
+        {
+            auto it = lblIds.emplace(lbl, labels.size());
+            if (it.second)
+                labels.push_back(lbl);
+            toGlobal.push_back(it.first->second);
+        }
+        for (Record& rec: chunk.recs)
+            rec.lbl = toGlobal[rec.lbl];
+        total += chunk.recs.size();
+    }
+
+    parsedRecords.reserve(total);
+    for (TextChunk& chunk: chunks)
+    {
+        parsedRecords.insert(parsedRecords.end(), chunk.recs.begin(), chunk.recs.end());
+        std::vector<Record>().swap(chunk.recs);
+    }
+    records = parsedRecords.data();
+    numOfEdges = parsedRecords.size();
+    return true;
+}
+
+
+/*!
+ * Records are sorted by source and deduplicated
+ */
+bool BinGraph::convert(const std::string& textFName, const std::string& binFName)
+{
+    BinGraph text;
+    if (!text.parseText(textFName, getNumOfThreads(0)))
+    {
+        std::cout << "error opening " << textFName << std::endl;
+        return false;
+    }
+    std::vector<std::string>& lblStrings = text.labels;
+    std::vector<Record>& recs = text.parsedRecords;
+
+    std::sort(recs.begin(), recs.end(), [](const Record& lhs, const Record& rhs)
+    {
+        return std::tie(lhs.src, lhs.dst, lhs.lbl, lhs.idx) < std::tie(rhs.src, rhs.dst, rhs.lbl, rhs.idx);
+    });
+    recs.erase(std::unique(recs.begin(), recs.end(), [](const Record& lhs, const Record& rhs)
+    {
+        return lhs.src == rhs.src && lhs.dst == rhs.dst && lhs.lbl == rhs.lbl && lhs.idx == rhs.idx;
+    }), recs.end());
+
+    std::string dict;
+    for (const std::string& lbl: lblStrings)
+    {
+        u32_t len = lbl.size();
+        dict.append((const char*) &len, sizeof(len));
+        dict.append(lbl);
+    }
+    dict.resize((dict.size() + sizeof(Record) - 1) / sizeof(Record) * sizeof(Record), '\0');
+
+    Header header;
+    memcpy(header.magic, binGraphMagic, sizeof(binGraphMagic));
+    header.version = Version;
+    header.numOfLabels = lblStrings.size();
+    header.numOfEdges = recs.size();
+    header.dictSize = dict.size();
+
+    std::ofstream outFile(binFName, std::ios::out | std::ios::binary | std::ios::trunc);
+    outFile.write((const char*) &header, sizeof(header));
+    outFile.write(dict.data(), dict.size());
+    outFile.write((const char*) recs.data(), recs.size() * sizeof(Record));
+    if (!outFile)
+    {
+        std::cout << "error writing " << binFName << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool BinGraph::writeText(const std::string& binFName, const std::string& textFName)
+{
+    BinGraph bg;
+    if (!bg.open(binFName))
+    {
+        std::cout << "error opening " << binFName << std::endl;
+        return false;
+    }
+
+    std::ofstream outFile(textFName, std::ios::out);
+    for (const Record& rec: bg)
+    {
+        const std::string& lbl = bg.getLabelString(rec.lbl);
+        outFile << rec.src << "\t" << rec.dst << "\t" << lbl;
+        if (rec.idx || (lbl.size() > 2 && lbl.compare(lbl.size() - 2, 2, "_i") == 0))
+            outFile << "\t" << rec.idx;
+        outFile << "\n";
+    }
+    return (bool) outFile;
+}
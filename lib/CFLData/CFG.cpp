@@ -3,7 +3,9 @@
 //
 
 #include "CFLSolver/CFLBase.h"
+#include "CFLSolver/StatSink.h"
 #include "CFLData/CFG.h"
+#include <algorithm>
 #include <iostream>
 
 using namespace SVF;
@@ -14,7 +16,9 @@ void CFG::parseGrammar(std::string fname)
 {
     readGrammarFile(fname);
     detectTransitiveSymbol();
-    printCFGStat();
+    compileRules();
+    if (StatSink::printsText())
+        printCFGStat();
 }
 
 
@@ -25,7 +29,7 @@ void CFG::readGrammarFile(std::string fname)
     if (!gFile.is_open())
     {
         std::cout << "error opening " << fname << std::endl;
-        exit(0);
+        exit(1);
     }
 
     std::string line;
@@ -130,6 +134,70 @@ void CFG::detectTransitiveSymbol()
 }
 
 
+void CFG::compileRules()
+{
+    numOfSlots = numOfSymbols + 1;
+
+    unaryOffsets.assign(numOfSlots + 1, 0);
+    compiledUnaryRules.clear();
+    unaryRhs.assign(numOfSlots, {});
+    for (CFGSymbTy rhs = 0; rhs < numOfSlots; ++rhs)
+    {
+        unaryOffsets[rhs] = compiledUnaryRules.size();
+        for (CFGSymbTy lhs : getLhs(rhs))
+        {
+            if (!lhs)       // a fault label
+                continue;
+            IdxSrc idxSrc = isaVariantSymbol(lhs) && isaVariantSymbol(rhs) ? LeftIdx : NoIdx;
+            compiledUnaryRules.push_back({lhs, idxSrc, false});
+            unaryRhs[lhs].push_back(rhs);
+        }
+    }
+    unaryOffsets[numOfSlots] = compiledUnaryRules.size();
+
+    /// only the existing rules are visited, ordered by their slots, as most symbol pairs have no rule
+    std::vector<std::pair<u32_t, std::pair<CFGSymbTy, CFGSymbTy>>> ruleSlots;
+    for (auto& rule : binaryRules)
+        if (!rule.second.empty())
+            ruleSlots.push_back(std::make_pair(rule.first.first * numOfSlots + rule.first.second, rule.first));
+    std::sort(ruleSlots.begin(), ruleSlots.end());
+
+    binaryOffsets.assign(numOfSlots * numOfSlots + 1, 0);
+    compiledBinaryRules.clear();
+    rightSymbols.assign(numOfSlots, {});
+    leftSymbols.assign(numOfSlots, {});
+    binaryRhs.assign(numOfSlots, {});
+    u32_t slot = 0;
+    for (auto& ruleSlot : ruleSlots)
+    {
+        for (; slot <= ruleSlot.first; ++slot)
+            binaryOffsets[slot] = compiledBinaryRules.size();
+
+        CFGSymbTy lRhs = ruleSlot.second.first;
+        CFGSymbTy rRhs = ruleSlot.second.second;
+        bool lVariant = isaVariantSymbol(lRhs);
+        bool rVariant = isaVariantSymbol(rRhs);
+        for (CFGSymbTy lhs : getLhs(ruleSlot.second))
+        {
+            if (!lhs)
+                continue;
+            IdxSrc idxSrc = NoIdx;
+            if (isaVariantSymbol(lhs))
+                idxSrc = lVariant ? LeftIdx : (rVariant ? RightIdx : NoIdx);
+            compiledBinaryRules.push_back({lhs, idxSrc, lVariant && rVariant});
+            binaryRhs[lhs].push_back(ruleSlot.second);
+        }
+        if (compiledBinaryRules.size() > binaryOffsets[ruleSlot.first])
+        {
+            rightSymbols[lRhs].push_back(rRhs);
+            leftSymbols[rRhs].push_back(lRhs);
+        }
+    }
+    for (; slot <= numOfSlots * numOfSlots; ++slot)
+        binaryOffsets[slot] = compiledBinaryRules.size();
+}
+
+
 void CFG::addSymbol(std::string& s)
 {
     if (hasSymbol(s))
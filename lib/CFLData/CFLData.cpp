@@ -0,0 +1,43 @@
+//
+// Backends of the CFL data
+//
+
+#include "CFLData/CFLData.h"
+#include "CFLSolver/CFLOpt.h"
+
+using namespace SVF;
+
+
+CFLData* CFLData::createCFLData()
+{
+    if (CFLOpt::flatData())
+        return new FlatCFLData();
+    return new CFLData();
+}
+
+
+/* ------------------- Methods of FlatCFLData ----------------- */
+
+void FlatCFLData::clear()
+{
+    lastLabel = Label(0, 0);
+    lastIdx = 0;
+    labelToIdxMap.clear();
+    labelToIdxMap[lastLabel] = lastIdx;
+
+    succTable.clear();
+    predTable.clear();
+    entryPool.clear();
+}
+
+
+void FlatCFLData::EntryTable::clear()
+{
+    entries.clear();
+    groups.clear();
+    lists.clear();
+    groupPool.clear();
+    keys.clear();
+    lastKey = emptyKey;
+    lastEntry = nullptr;
+}
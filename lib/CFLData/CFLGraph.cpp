@@ -5,6 +5,7 @@
 #include "CFLSolver/CFLBase.h"
 #include "Util/SVFUtil.h"
 #include "CFLData/CFLGraph.h"
+#include "CFLData/BinGraph.h"
 #include <iostream>
 
 using namespace SVF;
@@ -14,37 +15,32 @@ std::set<CFLEdge::GEdgeKind> CFLNode::directEdgeKinds;
 
 void CFLGraph::readGraph(std::string fname)
 {
-    std::ifstream gFile;
-    gFile.open(fname, std::ios::in);
-    if (!gFile.is_open()) {
+    BinGraph bg;
+    if (!bg.load(fname, getNumOfThreads(CFLOpt::threads()))) {
         std::cout << "error opening " << fname << std::endl;
-        exit(0);
+        exit(1);
     }
 
-    std::string line;
-    while (getline(gFile, line)) {
-        std::vector<std::string> vec = split(line, '\t');
-        if (vec.empty())
-            continue;
-
-        NodeID src = stoi(vec[0]);
-        NodeID dst = stoi(vec[1]);
+    /// labels out of the grammar are skipped
+    std::vector<s32_t> symbs;
+    for (u32_t i = 0; i < bg.getNumOfLabels(); ++i) {
+        std::string lblString = bg.getLabelString(i);
+        symbs.push_back(grammar->hasSymbol(lblString) ? grammar->getSymbolId(lblString) : -1);
+    }
 
-        std::string lblString = vec[2];
-        if (!grammar->hasSymbol(lblString))
+    for (const BinGraph::Record& rec: bg) {
+        if (symbs[rec.lbl] < 0)
             continue;
 
-        char lbl = grammar->getSymbolId(vec[2]);
-        addNode(src);
-        addNode(dst);
+        char lbl = symbs[rec.lbl];
+        addNode(rec.src);
+        addNode(rec.dst);
 
-        if (vec.size() == 4 && grammar->isaVariantSymbol(lbl))
-            addEdge(src, dst, lbl, std::stoi(vec[3]));
+        if (grammar->isaVariantSymbol(lbl))
+            addEdge(rec.src, rec.dst, lbl, rec.idx);
         else
-            addEdge(src, dst, lbl);
+            addEdge(rec.src, rec.dst, lbl);
     }
-
-    gFile.close();
 }
 
 
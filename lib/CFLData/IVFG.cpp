@@ -10,6 +10,7 @@
 #include "CFLSolver/CFLBase.h"
 #include "Util/SVFUtil.h"
 #include "CFLData/IVFG.h"
+#include "CFLData/BinGraph.h"
 #include <iostream>
 
 using namespace SVF;
@@ -29,48 +30,36 @@ IVFG::IVFG()
  */
 void IVFG::readGraph(std::string fname)
 {
-    std::ifstream gFile;
-    gFile.open(fname, std::ios::in);
-    if (!gFile.is_open())
+    BinGraph bg;
+    if (!bg.load(fname, getNumOfThreads(CFLOpt::threads())))
     {
         std::cout << "error opening " << fname << std::endl;
-        exit(0);
+        exit(1);
     }
 
-    NodeSet nodeSet;
-    std::string line;
-    while (getline(gFile, line))
+    /// -1 for labels that are neither IVFG edges nor source marks
+    const s32_t SrcMark = -2;
+    std::vector<s32_t> kinds;
+    for (u32_t i = 0; i < bg.getNumOfLabels(); ++i)
     {
-        std::vector<std::string> vec = split(line, '\t');
-        if (vec.empty())
-            continue;
-
-        NodeID src = stoi(vec[0]);
-        NodeID dst = stoi(vec[1]);
-        std::string lbl = vec[2];
-        addIVFGNode(src);
-        addIVFGNode(dst);
-
-        if (vec[2] == "a")
-        {
-            addEdge(src, dst, DirectVF);
-        }
-        if (vec[2] == "call_i")
-        {
-            addEdge(src, dst, CallVF, std::stoi(vec[3]));
-        }
-        if (vec[2] == "ret_i")
-        {
-            addEdge(src, dst, RetVF, std::stoi(vec[3]));
-        }
-        if (vec[2] == "src")
-        {
-            CFLNode* node = getIVFGNode(src);
-            node->setSrc();
-        }
+        const std::string& lbl = bg.getLabelString(i);
+        kinds.push_back(lbl == "a" ? DirectVF : lbl == "call_i" ? CallVF : lbl == "ret_i" ? RetVF :
+                        lbl == "src" ? SrcMark : -1);
     }
 
-    gFile.close();
+    for (const BinGraph::Record& rec: bg)
+    {
+        addIVFGNode(rec.src);
+        addIVFGNode(rec.dst);
+
+        s32_t kind = kinds[rec.lbl];
+        if (kind == DirectVF)
+            addEdge(rec.src, rec.dst, DirectVF);
+        else if (kind == CallVF || kind == RetVF)
+            addEdge(rec.src, rec.dst, kind, rec.idx);
+        else if (kind == SrcMark)
+            getIVFGNode(rec.src)->setSrc();
+    }
 }
 
 
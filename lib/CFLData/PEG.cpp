@@ -10,6 +10,7 @@
 #include "CFLSolver/CFLBase.h"
 #include "Util/SVFUtil.h"
 #include "CFLData/PEG.h"
+#include "CFLData/BinGraph.h"
 #include <iostream>
 
 using namespace SVF;
@@ -32,43 +33,32 @@ PEG::PEG() : maxNodeID(0)
  */
 void PEG::readGraph(std::string fname)
 {
-    std::ifstream gFile;
-    gFile.open(fname, std::ios::in);
-    if (!gFile.is_open())
+    BinGraph bg;
+    if (!bg.load(fname, getNumOfThreads(CFLOpt::threads())))
     {
         std::cout << "error opening " << fname << std::endl;
-        exit(0);
+        exit(1);
     }
 
-    NodeSet nodeSet;
-    std::string line;
-    while (getline(gFile, line))
+    /// -1 for labels that are not PEG edges
+    std::vector<s32_t> kinds;
+    for (u32_t i = 0; i < bg.getNumOfLabels(); ++i)
     {
-        std::vector<std::string> vec = split(line, '\t');
-        if (vec.empty())
-            continue;
-
-        NodeID src = stoi(vec[0]);
-        NodeID dst = stoi(vec[1]);
-        std::string lbl = vec[2];
-        addPEGNode(src);
-        addPEGNode(dst);
-
-        if (vec[2] == "a")
-        {
-            addEdge(src, dst, Asgn);
-        }
-        if (vec[2] == "d")
-        {
-            addEdge(src, dst, Deref);
-        }
-        if (vec[2] == "f_i")
-        {
-            addEdge(src, dst, Gep, std::stoi(vec[3]));
-        }
+        const std::string& lbl = bg.getLabelString(i);
+        kinds.push_back(lbl == "a" ? Asgn : lbl == "d" ? Deref : lbl == "f_i" ? Gep : -1);
     }
 
-    gFile.close();
+    for (const BinGraph::Record& rec: bg)
+    {
+        addPEGNode(rec.src);
+        addPEGNode(rec.dst);
+
+        s32_t kind = kinds[rec.lbl];
+        if (kind == Gep)
+            addEdge(rec.src, rec.dst, Gep, rec.idx);
+        else if (kind >= 0)
+            addEdge(rec.src, rec.dst, kind);
+    }
 }
 
 
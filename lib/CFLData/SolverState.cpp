@@ -0,0 +1,505 @@
+//
+// Saved states of CFL solvers
+//
+
+#include "CFLData/SolverState.h"
+#include <sys/mman.h>
+
+using namespace SVF;
+
+static const char stateMagic[8] = {'P', 'O', 'C', 'R', 'S', 'T', 'A', 'T'};
+
+const u32_t StateWriter::Version;
+
+
+StateWriter::StateWriter(const std::string& fname, const std::string& kind)
+        : out(fname, std::ios::out | std::ios::binary | std::ios::trunc), image(nullptr), sectionStart(0)
+{
+    writeHeader(kind);
+}
+
+
+StateWriter::StateWriter(std::vector<char>& _image, const std::string& kind) : image(&_image), sectionStart(0)
+{
+    image->clear();
+    writeHeader(kind);
+}
+
+
+void StateWriter::writeHeader(const std::string& kind)
+{
+    put(stateMagic, sizeof(stateMagic));
+    write(Version);
+    writeString(kind);
+}
+
+
+/*!
+ * A section is its tag, its length in bytes and its content
+ */
+void StateWriter::beginSection(SectionTy tag)
+{
+    sectionStart = tell();
+    write((u32_t) tag);
+    write((u64_t) 0);
+}
+
+
+void StateWriter::endSection()
+{
+    u64_t sectionEnd = tell();
+    u64_t len = sectionEnd - sectionStart - sizeof(u32_t) - sizeof(u64_t);
+    if (image)
+    {
+        memcpy(image->data() + sectionStart + sizeof(u32_t), &len, sizeof(len));
+        return;
+    }
+    out.seekp(sectionStart + sizeof(u32_t));
+    write(len);
+    out.seekp(sectionEnd);
+}
+
+
+/*!
+ * LEB128, 7 bits a byte from the lowest
+ */
+void StateWriter::writeVarint(u64_t val)
+{
+    char buf[10];
+    u32_t len = 0;
+    while (val >= 0x80)
+    {
+        buf[len++] = (char) (val | 0x80);
+        val >>= 7;
+    }
+    buf[len++] = (char) val;
+    put(buf, len);
+}
+
+
+void StateWriter::writeString(const std::string& str)
+{
+    writeVarint(str.size());
+    put(str.data(), str.size());
+}
+
+
+void StateWriter::writeNodeBS(const NodeBS& bs)
+{
+    elemIdxs.clear();
+    elemWords.clear();
+    for (NodeID n : bs)
+    {
+        u32_t idx = n / 128;
+        if (elemIdxs.empty() || elemIdxs.back() != idx)
+        {
+            elemIdxs.push_back(idx);
+            elemWords.push_back(0);
+            elemWords.push_back(0);
+        }
+        elemWords[elemWords.size() - 2 + (n % 128) / 64] |= 1ULL << (n % 64);
+    }
+
+    writeVarint(elemIdxs.size());
+    u32_t lastIdx = 0;
+    for (u32_t i = 0; i < elemIdxs.size(); ++i)
+    {
+        writeVarint(elemIdxs[i] - lastIdx);
+        lastIdx = elemIdxs[i];
+        write(elemWords[2 * i]);
+        write(elemWords[2 * i + 1]);
+    }
+}
+
+
+void StateWriter::writeSymbols(const Map<CFGSymbTy, std::string>& symbols)
+{
+    std::vector<CFGSymbTy> ids;
+    for (auto& iter : symbols)
+        ids.push_back(iter.first);
+    std::sort(ids.begin(), ids.end());
+
+    writeVarint(ids.size());
+    for (CFGSymbTy id : ids)
+    {
+        writeVarint(id);
+        writeString(symbols.at(id));
+    }
+}
+
+
+/*!
+ * Label entries of each node, successors and then predecessors,
+ * so that both directions are read word by word
+ */
+void StateWriter::writeData(CFLData& data)
+{
+    for (bool succ : {true, false})
+    {
+        NodeBS keys = succ ? data.getSuccKeys() : data.getPredKeys();
+        std::vector<u32_t> numOfEntries;
+        u32_t numOfKeys = 0;
+        for (NodeID key : keys)
+        {
+            u32_t num = 0;
+            for (auto& iter : succ ? data.getSuccs(key) : data.getPreds(key))
+                num += !iter.second.empty();
+            numOfEntries.push_back(num);
+            numOfKeys += num > 0;
+        }
+
+        writeVarint(numOfKeys);
+        NodeID lastKey = 0;
+        u32_t i = 0;
+        for (NodeID key : keys)
+        {
+            if (!numOfEntries[i++])
+                continue;
+            writeVarint(key - lastKey);
+            lastKey = key;
+            writeVarint(numOfEntries[i - 1]);
+            for (auto& iter : succ ? data.getSuccs(key) : data.getPreds(key))
+            {
+                if (iter.second.empty())
+                    continue;
+                writeVarint(iter.first.first);
+                writeVarint(iter.first.second);
+                writeNodeBS(iter.second);
+            }
+        }
+    }
+}
+
+
+/*!
+ * Each tree after its root in preorder, a tree node is its ID and its number of children
+ */
+void StateWriter::writeTrees(HybridData& trees)
+{
+    std::vector<NodeID> roots;
+    for (auto& iter : trees.indMap)
+        if (iter.second.find(iter.first) != iter.second.end())
+            roots.push_back(iter.first);
+    std::sort(roots.begin(), roots.end());
+
+    writeVarint(roots.size());
+    NodeID lastRoot = 0;
+    std::vector<HybridData::TreeNode*> nodeStack;
+    for (NodeID root : roots)
+    {
+        writeVarint(root - lastRoot);
+        lastRoot = root;
+        nodeStack.push_back(trees.indMap[root][root]);
+        bool isRoot = true;
+        while (!nodeStack.empty())
+        {
+            HybridData::TreeNode* node = nodeStack.back();
+            nodeStack.pop_back();
+            if (!isRoot)
+                writeVarint(node->id);
+            isRoot = false;
+            writeVarint(node->children.size());
+            for (HybridData::TreeNode* child : node->children)
+                nodeStack.push_back(child);
+        }
+    }
+}
+
+
+/*!
+ * Nodes, the successors of each node, and the reachable sets
+ */
+void StateWriter::writeECG(const ECG& ecg)
+{
+    NodeBS nodes;
+    for (auto& iter : ecg.getNodes())
+        nodes.set(iter.first);
+    writeNodeBS(nodes);
+    for (NodeID node : nodes)
+    {
+        NodeBS succs;
+        for (ECG::ECGNode* succ : ecg.getNodes().at(node)->successors)
+            succs.set(succ->id);
+        writeNodeBS(succs);
+    }
+
+    NodeBS keys;
+    for (auto& iter : ecg.getReachableMap())
+        keys.set(iter.first);
+    writeNodeBS(keys);
+    for (NodeID key : keys)
+        writeNodeBS(ecg.getReachableMap().at(key));
+}
+
+
+StateReader::StateReader(const std::string& fname) : base(nullptr), length(0), failed(false), pos(nullptr),
+                                                     end(nullptr)
+{
+    if (!mapFile(fname, base, length))
+    {
+        failed = true;
+        return;
+    }
+
+    pos = (const char*) base;
+    end = pos + length;
+    if (length < sizeof(stateMagic) || memcmp(pos, stateMagic, sizeof(stateMagic)) != 0)
+    {
+        failed = true;
+        return;
+    }
+    pos += sizeof(stateMagic);
+    if (read<u32_t>() != StateWriter::Version)
+    {
+        failed = true;
+        return;
+    }
+    kind = readString();
+
+    while (pos < end && !failed)
+    {
+        u32_t tag = read<u32_t>();
+        u64_t size = read<u64_t>();
+        if (failed || size > (u64_t) (end - pos))
+        {
+            failed = true;
+            break;
+        }
+        sections.push_back({tag, pos, pos + size});
+        pos += size;
+    }
+}
+
+
+StateReader::StateReader(const char* _pos, const char* _end) : base(nullptr), length(0), failed(false), pos(_pos),
+                                                              end(_end)
+{
+}
+
+
+StateReader::~StateReader()
+{
+    if (base)
+        munmap(base, length);
+}
+
+
+bool StateReader::openSection(StateWriter::SectionTy tag, u32_t nth)
+{
+    for (const Section& section : sections)
+    {
+        if (section.tag != tag || nth--)
+            continue;
+        pos = section.begin;
+        end = section.end;
+        return true;
+    }
+    pos = end;
+    return false;
+}
+
+
+u64_t StateReader::readVarint()
+{
+    u64_t val = 0;
+    for (u32_t shift = 0; shift < 64; shift += 7)
+    {
+        if (pos == end)
+            break;
+        u8_t byte = *pos++;
+        val |= (u64_t) (byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return val;
+    }
+    failed = true;
+    return 0;
+}
+
+
+std::string StateReader::readString()
+{
+    u64_t size = readVarint();
+    if (size > (u64_t) (end - pos))
+    {
+        failed = true;
+        return "";
+    }
+    std::string str(pos, size);
+    pos += size;
+    return str;
+}
+
+
+/*!
+ * Bits are set in ascending order, which a sparse bit vector appends without searching
+ */
+void StateReader::readNodeBS(NodeBS& bs)
+{
+    u64_t numOfElems = readVarint();
+    u64_t idx = 0;
+    for (u64_t i = 0; i < numOfElems && !failed; ++i)
+    {
+        idx += readVarint();
+        for (u32_t w = 0; w < 2; ++w)
+        {
+            u64_t word = read<u64_t>();
+            while (word)
+            {
+                bs.set(idx * 128 + w * 64 + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+    }
+}
+
+
+bool StateReader::findInNodeBS(NodeID id)
+{
+    bool found = false;
+    u64_t numOfElems = readVarint();
+    u64_t idx = 0;
+    for (u64_t i = 0; i < numOfElems && !failed; ++i)
+    {
+        idx += readVarint();
+        for (u32_t w = 0; w < 2; ++w)
+        {
+            u64_t word = read<u64_t>();
+            if (idx == id / 128 && w == (id % 128) / 64)
+                found = (word >> (id % 64)) & 1;
+        }
+    }
+    return found;
+}
+
+
+/*!
+ * A tree node is its ID and its number of children in preorder, the root is only the number of its children
+ */
+void StateReader::readTreeNodes(NodeBS* nodes)
+{
+    for (u64_t numOfNodes = readVarint(); numOfNodes && !failed; --numOfNodes)
+    {
+        NodeID id = readVarint();
+        if (nodes)
+            nodes->set(id);
+        numOfNodes += readVarint();
+    }
+}
+
+
+void StateReader::readSymbols(Map<CFGSymbTy, std::string>& symbols)
+{
+    u64_t num = readVarint();
+    for (u64_t i = 0; i < num && !failed; ++i)
+    {
+        CFGSymbTy id = readVarint();
+        symbols[id] = readString();
+    }
+}
+
+
+void StateReader::readData(CFLData& data)
+{
+    for (bool succ : {true, false})
+    {
+        u64_t numOfKeys = readVarint();
+        NodeID key = 0;
+        for (u64_t i = 0; i < numOfKeys && !failed; ++i)
+        {
+            key += readVarint();
+            u64_t numOfEntries = readVarint();
+            for (u64_t j = 0; j < numOfEntries && !failed; ++j)
+            {
+                CFGSymbTy symb = readVarint();
+                u32_t idx = readVarint();
+                Label lbl = std::make_pair(symb, idx);
+                readNodeBS(succ ? data.getSuccs(key, lbl) : data.getPreds(key, lbl));
+            }
+        }
+    }
+}
+
+
+/*!
+ * The trees are scanned first to size the node maps, as a node may be in many trees.
+ * Nodes already in the trees (e.g. the roots added by initialization) are kept.
+ */
+void StateReader::readTrees(HybridData& trees)
+{
+    const char* treesPos = pos;
+    Map<NodeID, u32_t> numOfTrees;
+    u64_t numOfRoots = readVarint();
+    NodeID root = 0;
+    for (u64_t i = 0; i < numOfRoots && !failed; ++i)
+    {
+        root += readVarint();
+        numOfTrees[root]++;
+        for (u64_t numOfNodes = readVarint(); numOfNodes && !failed; --numOfNodes)
+        {
+            numOfTrees[readVarint()]++;
+            numOfNodes += readVarint();
+        }
+    }
+    if (failed)
+        return;
+    trees.indMap.reserve(trees.indMap.size() + numOfTrees.size());
+    for (auto& iter : numOfTrees)
+    {
+        auto& inds = trees.indMap[iter.first];
+        inds.reserve(inds.size() + iter.second);
+    }
+
+    pos = treesPos;
+    readVarint();
+    root = 0;
+    std::vector<std::pair<HybridData::TreeNode*, u64_t>> nodeStack;    // nodes with their children to read
+    for (u64_t i = 0; i < numOfRoots; ++i)
+    {
+        root += readVarint();
+        auto rootIns = trees.indMap[root].emplace(root, nullptr);
+        if (rootIns.second)
+            rootIns.first->second = new HybridData::TreeNode(root);
+        nodeStack.emplace_back(rootIns.first->second, readVarint());
+        while (!nodeStack.empty())
+        {
+            if (!nodeStack.back().second)
+            {
+                nodeStack.pop_back();
+                continue;
+            }
+            nodeStack.back().second--;
+            NodeID id = readVarint();
+            auto resIns = trees.indMap[id].emplace(root, nullptr);
+            if (resIns.second)
+                resIns.first->second = new HybridData::TreeNode(id);
+            trees.insertTreeEdge(nodeStack.back().first, resIns.first->second);
+            nodeStack.emplace_back(resIns.first->second, readVarint());
+        }
+    }
+}
+
+
+void StateReader::readECG(ECG& ecg)
+{
+    NodeBS nodes;
+    readNodeBS(nodes);
+    for (NodeID node : nodes)
+        if (!ecg.hasNode(node))
+            ecg.addNode(node);
+    for (NodeID node : nodes)
+    {
+        NodeBS succs;
+        readNodeBS(succs);
+        for (NodeID succ : succs)
+            ecg.addEdge(node, succ);
+    }
+
+    NodeBS keys;
+    readNodeBS(keys);
+    for (NodeID key : keys)
+    {
+        NodeBS tgts;
+        readNodeBS(tgts);
+        ecg.setReachables(key, tgts);
+    }
+}
@@ -72,4 +72,118 @@ const Option<bool> CFLOpt::ecgSCC(
         false
 );
 
+const Option<bool> CFLOpt::flatData(
+        "flat-data",
+        "Store CFL data in label-indexed flat tables instead of nested maps",
+        false
+);
+
+const Option<bool> CFLOpt::setProp(
+        "set-prop",
+        "Propagate sets of new edges keyed by (source, label) in standard solvers",
+        false
+);
+
+const Option<u32_t> CFLOpt::threads(
+        "threads",
+        "Number of threads for parallel solvers (0 for all hardware threads)",
+        0
+);
+
+const Option<u32_t> CFLOpt::memBudget(
+        "mem-budget",
+        "Memory budget in MB for out-of-core Graspan solving (0 for in-memory solving)",
+        0
+);
+
+const Option<std::string> CFLOpt::partDir(
+        "part-dir",
+        "Directory holding partition files of out-of-core solving",
+        "/tmp"
+);
+
+const Option<std::string> CFLOpt::saveState(
+        "save-state",
+        "Save the solver state at the fixpoint into the specified file",
+        ""
+);
+
+const Option<std::string> CFLOpt::loadState(
+        "load-state",
+        "Resume solving from a saved state, taking the input graph as the added edges",
+        ""
+);
+
+const Option<std::string> CFLOpt::removedEdges(
+        "remove-edges",
+        "Remove the edges in the specified graph file from a state loaded by -load-state",
+        ""
+);
+
+const Option<std::string> CFLOpt::serve(
+        "serve",
+        "Answer reachability queries on the Unix socket of the specified path after solving",
+        ""
+);
+
+const Option<u32_t> CFLOpt::serveThreads(
+        "serve-threads",
+        "Number of threads answering queries (0 for all hardware threads)",
+        0
+);
+
+const Option<std::string> CFLOpt::profileRules(
+        "profile-rules",
+        "Profile each production rule while solving, print a ranked report and write it as CSV into the specified file",
+        ""
+);
+
+const Option<std::string> CFLOpt::statFormat(
+        "stat-format",
+        "Format of the statistics: text, json or csv",
+        "text"
+);
+
+const Option<std::string> CFLOpt::statFile(
+        "stat-file",
+        "Write json or csv statistics into the specified file instead of stdout",
+        ""
+);
+
+const Option<u32_t> CFLOpt::progress(
+        "progress",
+        "Print the progress of solving to stderr every specified seconds (0 for no progress)",
+        0
+);
+
+const Option<u32_t> CFLOpt::timeBudget(
+        "time-budget",
+        "Stop solving with a partial result after the specified seconds (0 for no budget)",
+        CFLOpt::timeOut
+);
+
+const Option<u32_t> CFLOpt::rssBudget(
+        "rss-budget",
+        "Stop solving with a partial result once the resident memory exceeds the specified MB (0 for no budget)",
+        0
+);
+
+const Option<std::string> CFLOpt::checkpoint(
+        "checkpoint",
+        "Write checkpoints of solving into the specified file periodically and when a budget runs out",
+        ""
+);
+
+const Option<u32_t> CFLOpt::checkpointInterval(
+        "checkpoint-interval",
+        "Seconds between two checkpoints (0 for only when a budget runs out)",
+        3600
+);
+
+const Option<std::string> CFLOpt::resume(
+        "resume",
+        "Resume solving on the same input from a checkpoint written by -checkpoint",
+        ""
+);
+
 } // namespace SVF.
@@ -4,21 +4,76 @@
 //
 
 #include "CFLSolver/CFLSolver.h"
+#include "CFLData/BinGraph.h"
 
 using namespace SVF;
 
 void StdCFL::initialize()
 {
+    double parseStart = CFLStat::getClk();
     _grammar = new CFG();
     _grammar->parseGrammar(grammarName);
 
-    _graph = new CFLGraph(_grammar);
-    _graph->readGraph(graphName);
+    if (needGraph())
+    {
+        _graph = new CFLGraph(_grammar);
+        _graph->readGraph(graphName);
+    }
+
+    /// states are kept and queries answered for the input nodes and labels, which simplification and UCFL change
+    if (!CFLOpt::saveState().empty() || !CFLOpt::loadState().empty() || !CFLOpt::serve().empty())
+    {
+        if (getStateKind().empty() || CFLOpt::scc() || CFLOpt::gf() || CFLOpt::ucfl())
+        {
+            std::cout << "solver states and queries are not supported with the given options" << std::endl;
+            exit(UnsupportedExit);
+        }
+    }
+    /// checkpoints are states with the pending items, of the same input
+    if (!CFLOpt::checkpoint().empty() || !CFLOpt::resume().empty())
+    {
+        if (!canCheckpoint() || CFLOpt::scc() || CFLOpt::gf() || CFLOpt::ucfl())
+        {
+            std::cout << "checkpoints are not supported with the given options" << std::endl;
+            exit(UnsupportedExit);
+        }
+        if (!CFLOpt::resume().empty() && !CFLOpt::loadState().empty())
+        {
+            std::cout << "a checkpoint is resumed without -load-state" << std::endl;
+            exit(UnsupportedExit);
+        }
+    }
+    if (CFLOpt::flatData() && !canUseFlatData())
+    {
+        std::cout << "-flat-data is not supported by the solver" << std::endl;
+        exit(UnsupportedExit);
+    }
+    /// only standard solving is rederived from the CFL data alone
+    if (!CFLOpt::removedEdges().empty() && (CFLOpt::loadState().empty() || getStateKind() != "std"))
+    {
+        std::cout << "edges are only removed from states of the standard solver (-load-state)" << std::endl;
+        exit(UnsupportedExit);
+    }
 
     stat = new CFLStat(this);
     stat->setMemUsageBefore();
+    stat->timeOfParsing = (stat->getClk() - parseStart) / TIMEINTERVAL;
+
+    if (!CFLOpt::profileRules().empty())
+    {
+        if (!canProfileRules())
+        {
+            std::cout << "rule profiling is not supported by the solver" << std::endl;
+            exit(UnsupportedExit);
+        }
+        profiler = new RuleProfiler(grammar(), &stat->checks, &worklist);
+    }
 
+    /// reading the input edges in initSolver() is counted as parsing
+    double initStart = stat->getClk();
+    double parseTime = stat->timeOfParsing;
     initSolver();
+    stat->timeOfInit = (stat->getClk() - initStart) / TIMEINTERVAL - (stat->timeOfParsing - parseTime);
 }
 
 
@@ -27,8 +82,146 @@ void StdCFL::finalize()
     stat->setMemUsageAfter();
 
     dumpStat();
+    if (profiler)
+    {
+        profiler->printReport(stat->timeOfSolving);
+        profiler->writeCSV(CFLOpt::profileRules());
+    }
     if (!CFLOpt::outGraphFName().empty())
         graph()->writeGraph(CFLOpt::outGraphFName());
+    /// a state is resumed as a fixpoint, which a partial result is not
+    if (!CFLOpt::saveState().empty())
+    {
+        if (isPartial())
+            std::cout << "the state is not saved as solving stopped before the fixpoint" << std::endl;
+        else
+            storeState(CFLOpt::saveState());
+    }
+}
+
+
+void StdCFL::storeState(const std::string& fname)
+{
+    StateWriter writer(fname, getStateKind());
+    saveState(writer);
+    if (!writer.good())
+        std::cout << "error writing " << fname << std::endl;
+}
+
+
+/*!
+ * A checkpoint is restored with its pending items
+ */
+void StdCFL::restoreState(const std::string& fname, bool isCheckpoint)
+{
+    double loadStart = stat->getClk();
+
+    StateReader reader(fname);
+    if (!reader.good())
+    {
+        std::cout << "error loading " << fname << ": not a state file of version " << StateWriter::Version
+                  << " or truncated" << std::endl;
+        exit(1);
+    }
+    std::string kind = isCheckpoint ? getCheckpointKind() : getStateKind();
+    if (reader.getKind() != kind)
+    {
+        std::cout << "error loading " << fname << ": not a " << (isCheckpoint ? "checkpoint" : "state") << " of the "
+                  << getStateKind() << " solver" << std::endl;
+        exit(1);
+    }
+    loadState(reader);
+    if (isCheckpoint && reader.good())
+        loadWorklist(reader);
+    if (!reader.good())
+    {
+        std::cout << "error loading " << fname << ": truncated state or another grammar" << std::endl;
+        exit(1);
+    }
+    restoredNodes = inputNodes;
+
+    double loadEnd = stat->getClk();
+    stat->timeOfLoadingState = (loadEnd - loadStart) / TIMEINTERVAL;
+}
+
+
+/*!
+ * The solving time accumulates over resumed solving
+ */
+void StdCFL::saveState(StateWriter& writer)
+{
+    writer.beginSection(StateWriter::Symbols);
+    writer.writeSymbols(grammar()->intToSymbMap);
+    writer.endSection();
+
+    writer.beginSection(StateWriter::Info);
+    writer.write(numOfInputEdges);
+    writer.write(stat->timeOfBaseSolving + stat->timeOfSolving);
+    writer.endSection();
+
+    writer.beginSection(StateWriter::Nodes);
+    writer.writeNodeBS(inputNodes);
+    writer.endSection();
+
+    writer.beginSection(StateWriter::Data);
+    writer.writeData(*cflData());
+    writer.endSection();
+
+    writer.beginSection(StateWriter::InputData);
+    writer.writeData(inputData);
+    writer.endSection();
+}
+
+
+/*!
+ * The symbols of the state have to be named as in the grammar
+ */
+void StdCFL::loadState(StateReader& reader)
+{
+    Map<CFGSymbTy, std::string> symbols;
+    if (!reader.openSection(StateWriter::Symbols))
+        reader.setFailed();
+    reader.readSymbols(symbols);
+    for (auto& iter : symbols)
+    {
+        auto it = grammar()->intToSymbMap.find(iter.first);
+        if (it == grammar()->intToSymbMap.end() || it->second != iter.second)
+            reader.setFailed();
+    }
+
+    if (!reader.openSection(StateWriter::Info))
+        reader.setFailed();
+    numOfInputEdges = reader.read<u32_t>();
+    stat->timeOfBaseSolving = reader.read<double>();
+
+    if (!reader.openSection(StateWriter::Nodes))
+        reader.setFailed();
+    reader.readNodeBS(inputNodes);
+
+    if (!reader.openSection(StateWriter::Data))
+        reader.setFailed();
+    reader.readData(*cflData());
+
+    if (!reader.openSection(StateWriter::InputData))
+        reader.setFailed();
+    reader.readData(inputData);
+}
+
+
+/*!
+ * The default symbol is the count symbol of the smallest ID
+ */
+void StdCFL::serveQueries(const std::string& sockPath)
+{
+    QueryServer server;
+    server.setData(cflData(), inputNodes);
+    server.addSymbols(grammar()->intToSymbMap);
+    if (!grammar()->countSymbols.empty())
+    {
+        CFGSymbTy countSymb = *std::min_element(grammar()->countSymbols.begin(), grammar()->countSymbols.end());
+        server.setDefaultSymbol(grammar()->intToSymbMap[countSymb]);
+    }
+    server.serve(sockPath, getNumOfThreads(CFLOpt::serveThreads()));
 }
 
 
@@ -36,7 +229,22 @@ void StdCFL::analyze()
 {
     initialize();
 
-    std::thread th(StdCFL::timer);      // timer thread
+    SolveBudget budget(CFLOpt::timeBudget(), CFLOpt::rssBudget());
+    setBudget(&budget);
+    budget.start();
+    ProgressSampler* sampler = nullptr;
+    if (CFLOpt::progress())
+    {
+        sampler = new ProgressSampler(grammar()->intToSymbMap, CFLOpt::progress());
+        setProgress(sampler->getProgress());
+        sampler->start();
+    }
+    if (!CFLOpt::checkpoint().empty())
+    {
+        checkpointer = new Checkpointer(CFLOpt::checkpoint(), CFLOpt::checkpointInterval());
+        setCheckpointDue(checkpointer->getDue());
+        checkpointer->start();
+    }
 
     /// start solving
     double propStart = stat->getClk();
@@ -46,22 +254,141 @@ void StdCFL::analyze()
         stat->numOfIteration++;
         reanalyze = false;
         if (CFLOpt::solveCFL())
-            solve();
-    } while (reanalyze);
+            solveWithCheckpoints(propStart);
+    } while (reanalyze && !isStopped());
 
     double propEnd = stat->getClk();
     stat->timeOfSolving += (propEnd - propStart) / TIMEINTERVAL;
 
+    if (sampler)
+    {
+        publishProgress();
+        sampler->stop();
+        setProgress(nullptr);
+        delete sampler;
+    }
+
+    budget.stop();
+    setBudget(nullptr);
+    partial = budget.isExceeded();
+    if (partial)
+        std::cout << "solving stopped as " << budget.getReason() << ", the result is partial" << std::endl;
+
+    /// a partial result is checkpointed to be resumed later
+    if (checkpointer)
+    {
+        checkpointer->stop();
+        setCheckpointDue(nullptr);
+        if (partial)
+        {
+            writeCheckpoint(stat->getClk());
+            checkpointer->wait();
+            std::cout << "solving can be resumed with -resume=" << CFLOpt::checkpoint() << std::endl;
+        }
+    }
+
     finalize();
+}
+
+
+/*!
+ * Solving leaves solve() at a safe point when a checkpoint is due, and is continued after writing it
+ */
+void StdCFL::solveWithCheckpoints(double solvingSince)
+{
+    solve();
+    while (checkpointer && checkpointer->isDue() && !isStopped())
+    {
+        writeCheckpoint(solvingSince);
+        solve();
+    }
+}
+
+
+/*!
+ * The solving time so far goes into the checkpoint, and is restored afterwards as solving goes on
+ */
+void StdCFL::writeCheckpoint(double solvingSince)
+{
+    checkpointer->write([this, solvingSince](std::vector<char>& image)
+    {
+        double solvingTime = stat->timeOfSolving;
+        stat->timeOfSolving += (stat->getClk() - solvingSince) / TIMEINTERVAL;
+        StateWriter writer(image, getCheckpointKind());
+        saveState(writer);
+        saveWorklist(writer);
+        stat->timeOfSolving = solvingTime;
+        return writer.good();
+    });
+}
+
+
+/*!
+ * Items of the worklist in order, and pending items of the set-mode worklist by (src, label)
+ */
+void StdCFL::saveWorklist(StateWriter& writer)
+{
+    writer.beginSection(StateWriter::Worklist);
+    writer.write(worklist.size());
+    worklist.forEach([&writer](const CFLItem& item)
+    {
+        writer.writeVarint(item.src());
+        writer.writeVarint(item.dst());
+        writer.writeVarint(item.label().first);
+        writer.writeVarint(item.label().second);
+        writer.write((u8_t) item.isPrimary());
+    });
+
+    writer.write((u64_t) pendingDsts.size());
+    for (auto& iter : pendingDsts)
+    {
+        writer.writeVarint(iter.first.first);
+        writer.writeVarint(iter.first.second.first);
+        writer.writeVarint(iter.first.second.second);
+        writer.writeNodeBS(iter.second);
+    }
+    writer.endSection();
+}
+
+
+/*!
+ * Items are pushed through pushIntoWorklist(), so that solvers rebuild their own lists of items
+ */
+void StdCFL::loadWorklist(StateReader& reader)
+{
+    if (!reader.openSection(StateWriter::Worklist))
+    {
+        reader.setFailed();
+        return;
+    }
 
-    pthread_cancel(th.native_handle());     // kill timer
-    th.join();
+    u64_t numOfItems = reader.read<u64_t>();
+    for (u64_t i = 0; i < numOfItems && reader.good(); ++i)
+    {
+        NodeID src = reader.readVarint();
+        NodeID dst = reader.readVarint();
+        CFGSymbTy symb = reader.readVarint();
+        u32_t idx = reader.readVarint();
+        bool isPrimary = reader.read<u8_t>();
+        pushIntoWorklist(src, dst, Label(symb, idx), isPrimary);
+    }
+
+    u64_t numOfSetItems = reader.read<u64_t>();
+    for (u64_t i = 0; i < numOfSetItems && reader.good(); ++i)
+    {
+        NodeID src = reader.readVarint();
+        CFGSymbTy symb = reader.readVarint();
+        u32_t idx = reader.readVarint();
+        NodeBS dstSet;
+        reader.readNodeBS(dstSet);
+        pushIntoSetWorklist(src, dstSet, Label(symb, idx));
+    }
 }
 
 
-Set<Label> StdCFL::unarySumm(Label lty)
+LabelSet StdCFL::unarySumm(Label lty)
 {
-    Set<Label> retVal;
+    LabelSet retVal;
     auto& lhsSet = grammar()->getLhs(lty.first);
 
     for (auto lhs : lhsSet)
@@ -79,10 +406,10 @@ Set<Label> StdCFL::unarySumm(Label lty)
 }
 
 
-Set<Label> StdCFL::binarySumm(Label lty, Label rty)
+LabelSet StdCFL::binarySumm(Label lty, Label rty)
 {
-    Set<Label> retVal;
-    auto lhsSet = grammar()->getLhs(std::make_pair(lty.first, rty.first));
+    LabelSet retVal;
+    auto& lhsSet = grammar()->getLhs(std::make_pair(lty.first, rty.first));
 
     for (auto lhs : lhsSet)
     {
@@ -115,19 +442,181 @@ Set<Label> StdCFL::binarySumm(Label lty, Label rty)
 }
 
 
+LabelSet StdCFL::compiledUnarySumm(Label lty)
+{
+    LabelSet retVal;
+    for (const CFG::CompiledRule& rule : grammar()->getCompiledRules(lty.first))
+        retVal.insert(rule.derive(lty));
+
+    return retVal;
+}
+
+
+LabelSet StdCFL::compiledBinarySumm(Label lty, Label rty)
+{
+    LabelSet retVal;
+    for (const CFG::CompiledRule& rule : grammar()->getCompiledRules(lty.first, rty.first))
+    {
+        if (rule.matchIdx && lty.second != rty.second)
+            continue;
+        retVal.insert(rule.derive(lty, rty));
+    }
+
+    return retVal;
+}
+
+
+void StdCFL::processCFLItem(CFLItem item)
+{
+    if (profiler)
+        procItem<true>(item);
+    else
+        procItem<false>(item);
+}
+
+
+void StdCFL::processSetItem(NodeID src, const NodeBS& dstSet, Label ty)
+{
+    if (profiler)
+        procSetItem<true>(src, dstSet, ty);
+    else
+        procSetItem<false>(src, dstSet, ty);
+}
+
+
+/*!
+ * Only the labels that have a production with the label of item are visited
+ */
+template<bool Profiled>
+void StdCFL::procItem(CFLItem item)
+{
+    /// Derive edges via unary production rules
+    for (Label newTy : unarySumm(item.label()))
+    {
+        RuleProbe<Profiled> probe(profiler, newTy.first, item.label().first);
+        if (checkAndAddEdge(item.src(), item.dst(), newTy))
+            pushIntoWorklist(item.src(), item.dst(), newTy);
+    }
+
+    /// Derive edges via binary production rules
+    //@{
+    for (CFGSymbTy rSymb : grammar()->getRightSymbols(item.label().first))
+    {
+        for (auto& iter : cflData()->getSymbSuccs(item.dst(), rSymb))
+        {
+            Label rty = iter.first;
+            for (Label newTy : binarySumm(item.label(), rty))
+            {
+                RuleProbe<Profiled> probe(profiler, newTy.first, item.label().first, rSymb);
+                for (NodeID dst : iter.second)
+                    if (checkAndAddEdge(item.src(), dst, newTy))
+                        pushIntoWorklist(item.src(), dst, newTy);
+            }
+        }
+    }
+
+    for (CFGSymbTy lSymb : grammar()->getLeftSymbols(item.label().first))
+    {
+        for (auto& iter : cflData()->getSymbPreds(item.src(), lSymb))
+        {
+            Label lty = iter.first;
+            for (Label newTy : binarySumm(lty, item.label()))
+            {
+                RuleProbe<Profiled> probe(profiler, newTy.first, lSymb, item.label().first);
+                for (NodeID src : iter.second)
+                    if (checkAndAddEdge(src, item.dst(), newTy))
+                        pushIntoWorklist(src, item.dst(), newTy);
+            }
+        }
+    }
+    //@}
+}
+
+
+/*!
+ * New edges of a set are pushed as a whole, so they are counted by the probes directly
+ */
+template<bool Profiled>
+void StdCFL::procSetItem(NodeID src, const NodeBS& dstSet, Label ty)
+{
+    /// Derive edges via unary production rules
+    for (Label newTy : unarySumm(ty))
+    {
+        RuleProbe<Profiled> probe(profiler, newTy.first, ty.first);
+        NodeBS newDsts = checkAndAddEdges(src, dstSet, newTy);
+        probe.addNewEdges(Profiled ? newDsts.count() : 0);
+        pushIntoSetWorklist(src, newDsts, newTy);
+    }
+
+    /// Derive edges via binary production rules
+    //@{
+    for (CFGSymbTy rSymb : grammar()->getRightSymbols(ty.first))
+    {
+        for (NodeID dst : dstSet)
+        {
+            for (auto& iter : cflData()->getSymbSuccs(dst, rSymb))
+                for (Label newTy : binarySumm(ty, iter.first))
+                {
+                    RuleProbe<Profiled> probe(profiler, newTy.first, ty.first, rSymb);
+                    NodeBS newDsts = checkAndAddEdges(src, iter.second, newTy);
+                    probe.addNewEdges(Profiled ? newDsts.count() : 0);
+                    pushIntoSetWorklist(src, newDsts, newTy);
+                }
+        }
+    }
+
+    for (CFGSymbTy lSymb : grammar()->getLeftSymbols(ty.first))
+    {
+        for (auto& iter : cflData()->getSymbPreds(src, lSymb))
+        {
+            for (Label newTy : binarySumm(iter.first, ty))
+            {
+                RuleProbe<Profiled> probe(profiler, newTy.first, lSymb, ty.first);
+                for (NodeID lSrc : iter.second)
+                {
+                    NodeBS newDsts = checkAndAddEdges(lSrc, dstSet, newTy);
+                    probe.addNewEdges(Profiled ? newDsts.count() : 0);
+                    pushIntoSetWorklist(lSrc, newDsts, newTy);
+                }
+            }
+        }
+    }
+    //@}
+}
+
+
+bool StdCFL::keepInputEdges()
+{
+    return !CFLOpt::saveState().empty() || !CFLOpt::loadState().empty() || !CFLOpt::checkpoint().empty()
+           || !CFLOpt::resume().empty();
+}
+
+
+bool StdCFL::needGraph()
+{
+    return CFLOpt::scc() || CFLOpt::gf() || !CFLOpt::outGraphFName().empty();
+}
+
+
 void StdCFL::initSolver()
 {
-    /// add all edges into adjacency list and worklist
-    for (auto edge : graph()->getCFLEdges())
+    /// resume from a saved fixpoint, where the input graph holds the added edges
+    if (!CFLOpt::loadState().empty())
     {
-        cflData()->addEdge(edge->getSrcID(), edge->getDstID(), std::make_pair(edge->getEdgeKind(), edge->getEdgeIdx()));
-        pushIntoWorklist(edge->getSrcID(), edge->getDstID(), std::make_pair(edge->getEdgeKind(), edge->getEdgeIdx()));
+        restoreState(CFLOpt::loadState());
+        if (!CFLOpt::removedEdges().empty())
+            removeInputEdges(CFLOpt::removedEdges());
     }
 
+    /// add all edges into adjacency list and worklist, which a checkpoint already holds
+    if (!CFLOpt::resume().empty())
+        restoreState(CFLOpt::resume(), true);
+    else
+        readInputEdges();
+
     /// processing empty rules, i.e., X ::= epsilon
-    for (auto nIter = graph()->begin(); nIter != graph()->end(); ++nIter)
+    for (NodeID nodeId : getNewInputNodes())
     {
-        NodeID nodeId = nIter->first;
         for (auto lhs : grammar()->getEmptyRules())
         {
             cflData()->addEdge(nodeId, nodeId, std::make_pair(lhs, 0));
@@ -137,6 +626,262 @@ void StdCFL::initSolver()
 }
 
 
+/*!
+ * Without the CFLGraph, edges are read as the CFLGraph would: labels out of the grammar are skipped,
+ * indices are kept for variant symbols only, and duplicated edges are added once
+ */
+void StdCFL::readInputEdges()
+{
+    if (graph())
+    {
+        for (auto edge : graph()->getCFLEdges())
+            addInputEdge(edge->getSrcID(), edge->getDstID(), std::make_pair(edge->getEdgeKind(), edge->getEdgeIdx()));
+        for (auto nIter = graph()->begin(); nIter != graph()->end(); ++nIter)
+            inputNodes.set(nIter->first);
+        return;
+    }
+
+    double readStart = stat->getClk();
+    readGraphFile(graphName, [this](NodeID src, NodeID dst, Label lbl)
+    {
+        inputNodes.set(src);
+        inputNodes.set(dst);
+        addInputEdge(src, dst, lbl);
+    });
+    stat->timeOfParsing += (stat->getClk() - readStart) / TIMEINTERVAL;
+}
+
+
+void StdCFL::readGraphFile(const std::string& fname, const std::function<void(NodeID, NodeID, Label)>& edgeFn)
+{
+    /// an empty file of added or removed edges keeps the loaded state, while BinGraph refuses empty graphs
+    if (!CFLOpt::loadState().empty())
+    {
+        std::ifstream file(fname);
+        if (file.is_open() && file.peek() == std::ifstream::traits_type::eof())
+            return;
+    }
+
+    BinGraph bg;
+    if (!bg.load(fname, getNumOfThreads(CFLOpt::threads())))
+    {
+        std::cout << "error opening " << fname << std::endl;
+        exit(1);
+    }
+
+    std::vector<s32_t> symbs;
+    for (u32_t i = 0; i < bg.getNumOfLabels(); ++i)
+    {
+        std::string lblString = bg.getLabelString(i);
+        symbs.push_back(grammar()->hasSymbol(lblString) ? grammar()->getSymbolId(lblString) : -1);
+    }
+
+    for (const BinGraph::Record& rec : bg)
+    {
+        if (symbs[rec.lbl] < 0)
+            continue;
+
+        CFGSymbTy symb = symbs[rec.lbl];
+        edgeFn(rec.src, rec.dst, std::make_pair(symb, grammar()->isaVariantSymbol(symb) ? rec.idx : 0));
+    }
+}
+
+
+/*!
+ * An input edge may have been derived in a resumed state, so it is counted by the input edges if they are kept
+ */
+void StdCFL::addInputEdge(NodeID src, NodeID dst, Label lbl)
+{
+    bool isNew = cflData()->checkAndAddEdge(src, dst, lbl);
+    if (isNew)
+        pushIntoWorklist(src, dst, lbl);
+    if (keepInputEdges() ? inputData.checkAndAddEdge(src, dst, lbl) : isNew)
+        numOfInputEdges++;
+}
+
+
+/*!
+ * Removed edges and the edges derived through them are over-deleted by applying the rules forwards on the old
+ * fixpoint. Over-deleted edges still derivable in one step from the remaining edges are then rederived, and so
+ * are the over-deleted edges derived from rederived ones. Added edges are solved afterwards as usual.
+ */
+void StdCFL::removeInputEdges(const std::string& fname)
+{
+    double removeStart = stat->getClk();
+
+    CFLData delData;
+    FIFOWorkList<CFLItem> delList;
+    auto overDelete = [&](NodeID src, const NodeBS& dsts, Label lbl)
+    {
+        NodeBS newDsts = dsts & cflData()->getSuccs(src, lbl);
+        newDsts.intersectWithComplement(delData.getSuccs(src, lbl));
+        delData.addEdges(src, newDsts, lbl);
+        for (NodeID dst : newDsts)
+            delList.push(CFLItem(src, dst, lbl));
+    };
+    auto overDeleteSrcs = [&](const NodeBS& srcs, NodeID dst, Label lbl)
+    {
+        NodeBS newSrcs = srcs & cflData()->getPreds(dst, lbl);
+        newSrcs.intersectWithComplement(delData.getPreds(dst, lbl));
+        delData.addEdges(newSrcs, dst, lbl);
+        for (NodeID src : newSrcs)
+            delList.push(CFLItem(src, dst, lbl));
+    };
+
+    NodeBS touchedNodes;
+    readGraphFile(fname, [&](NodeID src, NodeID dst, Label lbl)
+    {
+        if (!inputData.hasEdge(src, dst, lbl))
+            return;
+        inputData.getSuccs(src, lbl).reset(dst);
+        inputData.getPreds(dst, lbl).reset(src);
+        numOfInputEdges--;
+        touchedNodes.set(src);
+        touchedNodes.set(dst);
+        NodeBS dsts;
+        dsts.set(dst);
+        overDelete(src, dsts, lbl);
+    });
+
+    /// Nodes left without input edges are no longer input nodes, nor have empty-rule edges
+    for (NodeID node : touchedNodes)
+    {
+        bool hasInputEdges = false;
+        for (auto& iter : inputData.findSuccs(node))
+            hasInputEdges |= !iter.second.empty();
+        for (auto& iter : inputData.findPreds(node))
+            hasInputEdges |= !iter.second.empty();
+        if (hasInputEdges)
+            continue;
+
+        inputNodes.reset(node);
+        restoredNodes.reset(node);
+        NodeBS self;
+        self.set(node);
+        for (auto lhs : grammar()->getEmptyRules())
+            overDelete(node, self, std::make_pair(lhs, 0));
+    }
+
+    while (!delList.empty())
+    {
+        CFLItem item = delList.pop();
+        NodeBS self;
+        self.set(item.dst());
+        for (Label newTy : unarySumm(item.label()))
+            overDelete(item.src(), self, newTy);
+
+        for (CFGSymbTy rSymb : grammar()->getRightSymbols(item.label().first))
+            for (auto& iter : cflData()->getSymbSuccs(item.dst(), rSymb))
+                for (Label newTy : binarySumm(item.label(), iter.first))
+                    overDelete(item.src(), iter.second, newTy);
+
+        for (CFGSymbTy lSymb : grammar()->getLeftSymbols(item.label().first))
+            for (auto& iter : cflData()->getSymbPreds(item.src(), lSymb))
+                for (Label newTy : binarySumm(iter.first, item.label()))
+                    overDeleteSrcs(iter.second, item.dst(), newTy);
+    }
+
+    for (NodeID src : delData.getSuccKeys())
+        for (auto& iter : delData.getSuccs(src))
+        {
+            cflData()->getSuccs(src, iter.first).intersectWithComplement(iter.second);
+            for (NodeID dst : iter.second)
+                cflData()->getPreds(dst, iter.first).reset(src);
+        }
+
+    /// Rederive, the consequences of a rederived edge are either present or over-deleted,
+    /// so rules are only applied to over-deleted edges and the rederived ones need no further solving
+    auto rederive = [&](NodeID src, const NodeBS& dsts, Label lbl)
+    {
+        NodeBS newDsts = dsts & delData.getSuccs(src, lbl);
+        if (newDsts.empty())
+            return;
+        delData.getSuccs(src, lbl).intersectWithComplement(newDsts);
+        cflData()->addEdges(src, newDsts, lbl);
+        for (NodeID dst : newDsts)
+        {
+            delData.getPreds(dst, lbl).reset(src);
+            delList.push(CFLItem(src, dst, lbl));
+        }
+    };
+    auto rederiveSrcs = [&](const NodeBS& srcs, NodeID dst, Label lbl)
+    {
+        NodeBS newSrcs = srcs & delData.getPreds(dst, lbl);
+        if (newSrcs.empty())
+            return;
+        delData.getPreds(dst, lbl).intersectWithComplement(newSrcs);
+        cflData()->addEdges(newSrcs, dst, lbl);
+        for (NodeID src : newSrcs)
+        {
+            delData.getSuccs(src, lbl).reset(dst);
+            delList.push(CFLItem(src, dst, lbl));
+        }
+    };
+
+    std::vector<CFLItem> seeds;
+    for (NodeID src : delData.getSuccKeys())
+        for (auto& iter : delData.getSuccs(src))
+            for (NodeID dst : iter.second)
+                if (isDerivable(src, dst, iter.first))
+                    seeds.push_back(CFLItem(src, dst, iter.first));
+    for (const CFLItem& item : seeds)
+    {
+        NodeBS self;
+        self.set(item.dst());
+        rederive(item.src(), self, item.label());
+    }
+
+    while (!delList.empty())
+    {
+        CFLItem item = delList.pop();
+        NodeBS self;
+        self.set(item.dst());
+        for (Label newTy : unarySumm(item.label()))
+            rederive(item.src(), self, newTy);
+
+        for (CFGSymbTy rSymb : grammar()->getRightSymbols(item.label().first))
+            for (auto& iter : cflData()->getSymbSuccs(item.dst(), rSymb))
+                for (Label newTy : binarySumm(item.label(), iter.first))
+                    rederive(item.src(), iter.second, newTy);
+
+        for (CFGSymbTy lSymb : grammar()->getLeftSymbols(item.label().first))
+            for (auto& iter : cflData()->getSymbPreds(item.src(), lSymb))
+                for (Label newTy : binarySumm(iter.first, item.label()))
+                    rederiveSrcs(iter.second, item.dst(), newTy);
+    }
+
+    double removeEnd = stat->getClk();
+    stat->timeOfSolving += (removeEnd - removeStart) / TIMEINTERVAL;
+}
+
+
+/*!
+ * Whether an edge is an input edge, an empty-rule edge, or the lhs of a rule whose rhs edges are present
+ */
+bool StdCFL::isDerivable(NodeID src, NodeID dst, Label lbl)
+{
+    if (inputData.hasEdge(src, dst, lbl))
+        return true;
+    if (src == dst && grammar()->getEmptyRules().count(lbl.first) && inputNodes.test(src))
+        return true;
+
+    for (CFGSymbTy rhs : grammar()->getUnaryRhs(lbl.first))
+        for (auto& iter : cflData()->getSymbSuccs(src, rhs))
+            if (iter.second.test(dst) && unarySumm(iter.first).contains(lbl))
+                return true;
+
+    for (auto& rhs : grammar()->getBinaryRhs(lbl.first))
+        for (auto& lIter : cflData()->getSymbSuccs(src, rhs.first))
+            for (auto& rIter : cflData()->getSymbPreds(dst, rhs.second))
+            {
+                stat->checks++;
+                if (lIter.second.intersects(rIter.second) && binarySumm(lIter.first, rIter.first).contains(lbl))
+                    return true;
+            }
+    return false;
+}
+
+
 void StdCFL::dumpStat()
 {
     if (CFLOpt::PStat() && stat)
@@ -148,16 +893,16 @@ void StdCFL::countSumEdges()
 {
     /// calculate summary edges
     stat->numOfSumEdges = 0;
-    for (auto it1 = cflData()->begin(); it1 != cflData()->end(); ++it1)
-        for (auto& it2 : it1->second)
+    for (NodeID src : cflData()->getSuccKeys())
+        for (auto& it2 : cflData()->getSuccs(src))
             stat->numOfSumEdges += it2.second.count();
 
     /// calculate S edges
     stat->sEdgeSet.clear();
-    for (auto& it1 : cflData()->getSuccMap())
-        for (auto& it2 : it1.second)
+    for (NodeID src : cflData()->getSuccKeys())
+        for (auto& it2 : cflData()->getSuccs(src))
             if (grammar()->isCountSymbol(it2.first.first))
-                stat->sEdgeSet[it1.first] |= it2.second;
+                stat->sEdgeSet[src] |= it2.second;
 
     for (auto& it : stat->sEdgeSet)
         it.second.reset(it.first);
@@ -10,24 +10,34 @@
 
 using namespace SVF;
 
+/*!
+ * Printed stats are added to the structured ones, and printed only in the text format
+ */
 void CFLStat::printStat(std::string statname)
 {
     std::cout.flags(std::ios::left);
     unsigned field_width = 20;
+    bool printsText = StatSink::printsText();
     for (NUMStatMap::iterator it = generalNumMap.begin(), eit = generalNumMap.end(); it != eit; ++it)
     {
+        sink.add("counters", it->first, it->second);
         // format out put with width 20 space
-        std::cout << std::setw(field_width) << it->first << it->second << "\n";
+        if (printsText)
+            std::cout << std::setw(field_width) << it->first << it->second << "\n";
     }
     for (TIMEStatMap::iterator it = timeStatMap.begin(), eit = timeStatMap.end(); it != eit; ++it)
     {
+        sink.add(strcmp(it->first, "VmrssInGB") ? "times" : "memory", it->first, it->second);
         // format out put with width 20 space
-        std::cout << std::setw(field_width) << it->first << it->second << "\n";
+        if (printsText)
+            std::cout << std::setw(field_width) << it->first << it->second << "\n";
     }
     for (NUMStatMap::iterator it = PTNumStatMap.begin(), eit = PTNumStatMap.end(); it != eit; ++it)
     {
+        sink.add("counters", it->first, it->second);
         // format out put with width 20 space
-        std::cout << std::setw(field_width) << it->first << it->second << "\n";
+        if (printsText)
+            std::cout << std::setw(field_width) << it->first << it->second << "\n";
     }
 
     std::cout.flush();
@@ -39,13 +49,8 @@ void CFLStat::printStat(std::string statname)
 
 void CFLStat::graphStat()
 {
-    CFLGraph* g = cfl->graph();
-
-    for (auto nodeIt = g->begin(); nodeIt != g->end(); nodeIt++)
-        numOfNodes++;
-
-    for (auto it : g->getCFLEdges())
-        numOfEdges++;
+    numOfNodes = cfl->getInputNodes().count();
+    numOfEdges = cfl->getNumOfInputEdges();
 
     PTNumStatMap["#Nodes"] = numOfNodes;
     PTNumStatMap["#Edges"] = numOfEdges;
@@ -59,21 +64,54 @@ void CFLStat::performStat()
     endClk();
 
     graphStat();
+    double countStart = getClk();
     cfl->countSumEdges();
+    timeOfCounting = (getClk() - countStart) / TIMEINTERVAL;
 
     timeStatMap["AnalysisTime"] = timeOfSolving;
+    if (wallTimeOfSolving)
+        timeStatMap["WallSolvingTime"] = wallTimeOfSolving;
+    if (!CFLOpt::loadState().empty() || !CFLOpt::resume().empty())
+    {
+        timeStatMap["LoadStateTime"] = timeOfLoadingState;
+        timeStatMap["BaseAnalysisTime"] = timeOfBaseSolving;
+    }
     timeStatMap["VmrssInGB"] = (_vmrssUsageAfter - _vmrssUsageBefore) / 1024.0 / 1024.0;
     PTNumStatMap["#Checks"] = checks;
     PTNumStatMap["#SumEdges"] = numOfSumEdges - numOfEdges;
     PTNumStatMap["#CountEdges"] = numOfCountEdges;
+    if (cfl->isPartial())
+        PTNumStatMap["Partial"] = 1;
 
     CFLStat::printStat("CFL-reachability analysis Stats");
+    writeStructuredStat();
 
     if (!CFLOpt::sPairsFName().empty())
         writeSPairsIntoFile(CFLOpt::sPairsFName());
 }
 
 
+/*!
+ * Phases in seconds, the solving phase includes resumed solving and removal of edges
+ */
+void CFLStat::writeStructuredStat()
+{
+    if (StatSink::getFormat() == StatSink::Text)
+        return;
+
+    sink.add("phases", "parse", timeOfParsing);
+    if (!CFLOpt::loadState().empty() || !CFLOpt::resume().empty())
+        sink.add("phases", "loadState", timeOfLoadingState);
+    sink.add("phases", "init", timeOfInit);
+    sink.add("phases", "solve", timeOfSolving);
+    sink.add("phases", "count", timeOfCounting);
+    sink.add("counters", "#Iterations", (u64_t) numOfIteration);
+    sink.addPeakMemory();
+    sink.addIdentity({{"grammar", cfl->getGrammarName()}, {"graph", cfl->getGraphName()}});
+    sink.write();
+}
+
+
 void CFLStat::setMemUsageBefore()
 {
     u32_t vmrss, vmsize;
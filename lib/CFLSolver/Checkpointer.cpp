@@ -0,0 +1,98 @@
+//
+// Periodic checkpoints of solving
+//
+
+#include "CFLSolver/Checkpointer.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+using namespace SVF;
+
+
+/*!
+ * Checkpoints are only written when a budget runs out for a zero interval
+ */
+void Checkpointer::start()
+{
+    if (interval == 0)
+        return;
+    th = std::thread(&Checkpointer::run, this);
+}
+
+
+void Checkpointer::stop()
+{
+    if (th.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopped = true;
+        }
+        cv.notify_one();
+        th.join();
+    }
+    waitWriter(true);
+}
+
+
+void Checkpointer::run()
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!cv.wait_for(lock, std::chrono::seconds(interval), [this]()
+    { return stopped; }))
+        due.store(true, std::memory_order_relaxed);
+}
+
+
+/*!
+ * The image is only touched by the writer thread until it is joined
+ */
+void Checkpointer::write(const std::function<bool(std::vector<char>&)>& fillFn)
+{
+    due.store(false, std::memory_order_relaxed);
+    if (!waitWriter(false))
+    {
+        std::cout << "checkpoint skipped, the last one is still being written" << std::endl;
+        return;
+    }
+
+    if (!fillFn(image))
+    {
+        std::cout << "error writing checkpoint " << fname << std::endl;
+        return;
+    }
+    writing.store(true);
+    writer = std::thread(&Checkpointer::writeImage, this);
+    numOfCheckpoints++;
+}
+
+
+void Checkpointer::writeImage()
+{
+    std::string tmpName = fname + ".tmp";
+    {
+        std::ofstream out(tmpName, std::ios::out | std::ios::binary | std::ios::trunc);
+        out.write(image.data(), image.size());
+        out.close();
+        writeFailed.store(!out || rename(tmpName.c_str(), fname.c_str()) != 0);
+    }
+    /// the image is released, so that it only takes memory while being written
+    std::vector<char>().swap(image);
+    writing.store(false);
+}
+
+
+bool Checkpointer::waitWriter(bool block)
+{
+    if (!writer.joinable())
+        return true;
+    if (!block && writing.load())
+        return false;
+
+    writer.join();
+    if (writeFailed.load())
+        std::cout << "error writing checkpoint " << fname << std::endl;
+    return true;
+}
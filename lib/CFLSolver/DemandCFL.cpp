@@ -0,0 +1,273 @@
+/* -------------------- DemandCFL.cpp ------------------ */
+//
+// Demand-driven CFL-reachability
+//
+
+#include "CFLSolver/CFLSolver.h"
+
+using namespace SVF;
+
+
+DemandCFL::DemandCFL(std::string& _grammarName, std::string& _graphName, std::string _queryFName, bool _backward)
+        : StdCFL(_grammarName, _graphName),
+          backward(_backward),
+          queryFName(std::move(_queryFName))
+{
+}
+
+
+/*!
+ * Count symbols are demanded at the query nodes, input edges are only stored
+ */
+void DemandCFL::initSolver()
+{
+    readInputEdges();
+    readQueryNodes();
+    for (CFGSymbTy symb : grammar()->countSymbols)
+        for (NodeID node : queryNodes)
+            demand(symb, node);
+}
+
+
+void DemandCFL::addInputEdge(NodeID src, NodeID dst, Label lbl)
+{
+    if (inputData.checkAndAddEdge(src, dst, lbl))
+        numOfInputEdges++;
+}
+
+
+/*!
+ * Node IDs separated by white spaces
+ */
+void DemandCFL::readQueryNodes()
+{
+    std::ifstream qFile(queryFName, std::ios::in);
+    if (!qFile.is_open())
+    {
+        std::cout << "error opening " << queryFName << std::endl;
+        exit(1);
+    }
+
+    NodeID node;
+    while (qFile >> node)
+        queryNodes.set(node);
+}
+
+
+void DemandCFL::demand(CFGSymbTy symb, NodeID node)
+{
+    if (demands[symb].test_and_set(node))
+        demandList.push(Demand(symb, node));
+}
+
+
+/*!
+ * Demands are resolved before edges, so that edges are derived only once their demands have spread
+ */
+void DemandCFL::solve()
+{
+    while ((!demandList.empty() || !isWorklistEmpty()) && !isStopped())
+    {
+        if (!demandList.empty())
+            processDemand(demandList.pop());
+        else
+        {
+            CFLItem item = popFromWorklist();
+            countItem(item.label());
+            processCFLItem(item);
+        }
+    }
+}
+
+
+/*!
+ * A new demand (X, n) brings in the input X-edges at n, spreads to the rhs symbols of the rules of X,
+ * and derives X-edges from the edges that were already there before X was demanded
+ */
+void DemandCFL::processDemand(const Demand& dmd)
+{
+    CFGSymbTy symb = dmd.first;
+    NodeID node = dmd.second;
+
+    /// input edges
+    for (auto& iter : backward ? inputData.getSymbPreds(node, symb) : inputData.getSymbSuccs(node, symb))
+    {
+        Label lbl = iter.first;
+        for (NodeID adj : iter.second)
+        {
+            NodeID src = backward ? adj : node;
+            NodeID dst = backward ? node : adj;
+            if (checkAndAddEdge(src, dst, lbl))
+                pushIntoWorklist(src, dst, lbl);
+        }
+    }
+    if (isTerminal(symb))
+        return;
+
+    /// X ::= epsilon
+    if (grammar()->getEmptyRules().count(symb) && inputNodes.test(node))
+        addDemandedEdge(node, node, std::make_pair(symb, 0));
+
+    /// X ::= Y
+    for (CFGSymbTy rhs : grammar()->getUnaryRhs(symb))
+    {
+        demand(rhs, node);
+        for (auto& iter : backward ? cflData()->getSymbPreds(node, rhs) : cflData()->getSymbSuccs(node, rhs))
+            for (Label newTy : unarySumm(iter.first))
+            {
+                if (newTy.first != symb)
+                    continue;
+                for (NodeID adj : iter.second)
+                    addDemandedEdge(backward ? adj : node, backward ? node : adj, newTy);
+            }
+    }
+
+    /// X ::= Y Z, forward demands Y at n and Z after Y-edges, backward demands Z at n and Y before Z-edges
+    for (auto& rhs : grammar()->getBinaryRhs(symb))
+    {
+        CFGSymbTy first = backward ? rhs.second : rhs.first;
+        CFGSymbTy second = backward ? rhs.first : rhs.second;
+        demand(first, node);
+        for (auto& iter : backward ? cflData()->getSymbPreds(node, first) : cflData()->getSymbSuccs(node, first))
+        {
+            for (NodeID mid : iter.second)
+            {
+                demand(second, mid);
+                for (auto& iter2 : backward ? cflData()->getSymbPreds(mid, second) : cflData()->getSymbSuccs(mid, second))
+                    for (Label newTy : backward ? binarySumm(iter2.first, iter.first) : binarySumm(iter.first, iter2.first))
+                    {
+                        if (newTy.first != symb)
+                            continue;
+                        for (NodeID adj : iter2.second)
+                            addDemandedEdge(backward ? adj : node, backward ? node : adj, newTy);
+                    }
+            }
+        }
+    }
+}
+
+
+void DemandCFL::addDemandedEdge(NodeID src, NodeID dst, Label lbl)
+{
+    if (!isDemanded(lbl.first, backward ? dst : src))
+        return;
+    if (checkAndAddEdge(src, dst, lbl))
+        pushIntoWorklist(src, dst, lbl);
+}
+
+
+void DemandCFL::processCFLItem(CFLItem item)
+{
+    if (backward)
+        processBackward(item);
+    else
+        processForward(item);
+}
+
+
+/*!
+ * An edge Y(u, w) exists only if Y is demanded at u
+ */
+void DemandCFL::processForward(const CFLItem& item)
+{
+    NodeID src = item.src();
+    NodeID dst = item.dst();
+    Label ty = item.label();
+
+    /// X ::= Y
+    for (Label newTy : unarySumm(ty))
+        addDemandedEdge(src, dst, newTy);
+
+    /// X ::= Y Z, Z is demanded at w when X is demanded at u
+    for (CFGSymbTy rSymb : grammar()->getRightSymbols(ty.first))
+    {
+        bool demanded = false;
+        for (const CFG::CompiledRule& rule : grammar()->getCompiledRules(ty.first, rSymb))
+            demanded |= isDemanded(rule.lhs, src);
+        if (!demanded)
+            continue;
+
+        demand(rSymb, dst);
+        for (auto& iter : cflData()->getSymbSuccs(dst, rSymb))
+            for (Label newTy : binarySumm(ty, iter.first))
+                for (NodeID rDst : iter.second)
+                    addDemandedEdge(src, rDst, newTy);
+    }
+
+    /// X ::= Z Y
+    for (CFGSymbTy lSymb : grammar()->getLeftSymbols(ty.first))
+    {
+        for (auto& iter : cflData()->getSymbPreds(src, lSymb))
+            for (Label newTy : binarySumm(iter.first, ty))
+                for (NodeID lSrc : iter.second)
+                    addDemandedEdge(lSrc, dst, newTy);
+    }
+}
+
+
+/*!
+ * An edge Y(u, w) exists only if Y is demanded at w
+ */
+void DemandCFL::processBackward(const CFLItem& item)
+{
+    NodeID src = item.src();
+    NodeID dst = item.dst();
+    Label ty = item.label();
+
+    /// X ::= Y
+    for (Label newTy : unarySumm(ty))
+        addDemandedEdge(src, dst, newTy);
+
+    /// X ::= Z Y, Z is demanded at u when X is demanded at w
+    for (CFGSymbTy lSymb : grammar()->getLeftSymbols(ty.first))
+    {
+        bool demanded = false;
+        for (const CFG::CompiledRule& rule : grammar()->getCompiledRules(lSymb, ty.first))
+            demanded |= isDemanded(rule.lhs, dst);
+        if (!demanded)
+            continue;
+
+        demand(lSymb, src);
+        for (auto& iter : cflData()->getSymbPreds(src, lSymb))
+            for (Label newTy : binarySumm(iter.first, ty))
+                for (NodeID lSrc : iter.second)
+                    addDemandedEdge(lSrc, dst, newTy);
+    }
+
+    /// X ::= Y Z
+    for (CFGSymbTy rSymb : grammar()->getRightSymbols(ty.first))
+    {
+        for (auto& iter : cflData()->getSymbSuccs(dst, rSymb))
+            for (Label newTy : binarySumm(ty, iter.first))
+                for (NodeID rDst : iter.second)
+                    addDemandedEdge(src, rDst, newTy);
+    }
+}
+
+
+/*!
+ * Input edges count as in the exhaustive solvers, and only count edges at the query nodes are reported
+ */
+void DemandCFL::countSumEdges()
+{
+    StdCFL::countSumEdges();
+
+    for (NodeID src : cflData()->getSuccKeys())
+        for (auto& iter : cflData()->getSuccs(src))
+            if (isTerminal(iter.first.first))
+                stat->numOfSumEdges -= iter.second.count();
+    stat->numOfSumEdges += numOfInputEdges;
+
+    for (auto it = stat->sEdgeSet.begin(); it != stat->sEdgeSet.end();)
+    {
+        if (backward)
+            it->second &= queryNodes;
+        if ((!backward && !queryNodes.test(it->first)) || it->second.empty())
+            it = stat->sEdgeSet.erase(it);
+        else
+            ++it;
+    }
+    stat->numOfCountEdges = 0;
+    for (auto& it : stat->sEdgeSet)
+        stat->numOfCountEdges += it.second.count();
+}
@@ -9,73 +9,143 @@ using namespace SVF;
 
 void FocrCFL::initSolver()
 {
-    StdCFL::initSolver();
-    /// Initialize ECG
+    /// Initialize ECG, before a saved state is loaded into them
     for (auto lbl : grammar()->transitiveSymbols)
         ecgs[lbl] = new ECG();
+    StdCFL::initSolver();
     /// Create ECG nodes
-    for (auto it = graph()->begin(); it != graph()->end(); ++it)
+    for (NodeID nId : getNewInputNodes())
     {
         for (auto lbl : grammar()->transitiveSymbols)
         {
-            NodeID nId = it->first;
             ecgs[lbl]->addNode(nId);
         }
     }
     /// Remove transitive rules from binary-summarization list
     for (auto lbl : grammar()->transitiveSymbols)
         grammar()->binaryRules[std::make_pair(lbl, lbl)].erase(lbl);
+    grammar()->compileRules();
+}
+
+
+/*!
+ * A section for each transitive symbol, with its ECG
+ */
+void FocrCFL::saveState(StateWriter& writer)
+{
+    StdCFL::saveState(writer);
+    for (auto lbl : grammar()->transitiveSymbols)
+    {
+        writer.beginSection(StateWriter::ECGs);
+        writer.write(lbl);
+        writer.writeECG(*ecgs[lbl]);
+        writer.endSection();
+    }
+}
+
+
+void FocrCFL::loadState(StateReader& reader)
+{
+    StdCFL::loadState(reader);
+    for (u32_t i = 0; i < grammar()->transitiveSymbols.size() && reader.good(); ++i)
+    {
+        if (!reader.openSection(StateWriter::ECGs, i))
+            reader.setFailed();
+        CFGSymbTy lbl = reader.read<CFGSymbTy>();
+        if (!grammar()->isTransitive(lbl))
+        {
+            reader.setFailed();
+            break;
+        }
+        reader.readECG(*ecgs[lbl]);
+    }
 }
 
 
 void FocrCFL::processCFLItem(CFLItem item)
+{
+    if (profiler)
+        procItem<true>(item);
+    else
+        procItem<false>(item);
+}
+
+
+/*!
+ * Primary transitive items are profiled as X ::= X X, with the checks in the ECGs as derivations
+ */
+template<bool Profiled>
+void FocrCFL::procItem(CFLItem item)
 {
     /// Process primary transitive items
     if (grammar()->isTransitive(item.label().first) && isPrimary(item))
     {
+        CFGSymbTy symb = item.label().first;
+        RuleProbe<Profiled> probe(profiler, symb, symb, symb);
+        u64_t treeChecks = Profiled ? ecgs[symb]->checks : 0;
+        CFLItem secondary(item.src(), item.dst(), item.label(), false);
+        bool isQueued = Profiled && isInWorklist(secondary);
         procPrimaryItem(item);
+        probe.addDerivations(Profiled ? ecgs[symb]->checks - treeChecks : 0);
+        /// the item itself is pushed again as a secondary item
+        probe.discountNewEdges(Profiled && !isQueued && isInWorklist(secondary));
         return;
     }
 
     /// Process other items
     for (Label newTy : unarySumm(item.label()))
+    {
+        RuleProbe<Profiled> probe(profiler, newTy.first, item.label().first);
         if (checkAndAddEdge(item.src(), item.dst(), newTy))
             pushIntoWorklist(item.src(), item.dst(), newTy);
+    }
 
-    for (auto& iter : cflData()->getSuccs(item.dst()))
+    for (CFGSymbTy rSymb : grammar()->getRightSymbols(item.label().first))
     {
-        Label rty = iter.first;
-        for (Label newTy : binarySumm(item.label(), rty))
-            if (newTy == item.label() && grammar()->isTransitive(rty.first))
-            {
-                /// X ::= X A
-                ECGNode* dst = ecgs[rty.first]->getNode(item.dst());
-                checkSuccs(newTy, item.src(), dst);
-            }
-            else
+        for (auto& iter : cflData()->getSymbSuccs(item.dst(), rSymb))
+        {
+            Label rty = iter.first;
+            for (Label newTy : binarySumm(item.label(), rty))
             {
-                NodeBS diffDsts = checkAndAddEdges(item.src(), iter.second, newTy);
-                for (NodeID diffDst : diffDsts)
-                    pushIntoWorklist(item.src(), diffDst, newTy);
+                RuleProbe<Profiled> probe(profiler, newTy.first, item.label().first, rSymb);
+                if (newTy == item.label() && grammar()->isTransitive(rty.first))
+                {
+                    /// X ::= X A
+                    ECGNode* dst = ecgs[rty.first]->getNode(item.dst());
+                    checkSuccs(newTy, item.src(), dst);
+                }
+                else
+                {
+                    NodeBS diffDsts = checkAndAddEdges(item.src(), iter.second, newTy);
+                    for (NodeID diffDst : diffDsts)
+                        pushIntoWorklist(item.src(), diffDst, newTy);
+                }
             }
+        }
     }
 
-    for (auto& iter : cflData()->getPreds(item.src()))
+    for (CFGSymbTy lSymb : grammar()->getLeftSymbols(item.label().first))
     {
-        Label lty = iter.first;
-        for (Label newTy : binarySumm(lty, item.label()))
-            if (newTy == item.label() && grammar()->isTransitive(lty.first))
-            {
-                /// X ::= A X
-                ECGNode* src = ecgs[lty.first]->getNode(item.src());
-                checkPreds(newTy, src, item.dst());
-            }
-            else
+        for (auto& iter : cflData()->getSymbPreds(item.src(), lSymb))
+        {
+            Label lty = iter.first;
+            for (Label newTy : binarySumm(lty, item.label()))
             {
-                NodeBS diffSrcs = checkAndAddEdges(iter.second, item.dst(), newTy);
-                for (NodeID diffSrc : diffSrcs)
-                    pushIntoWorklist(diffSrc, item.dst(), newTy);
+                RuleProbe<Profiled> probe(profiler, newTy.first, lSymb, item.label().first);
+                if (newTy == item.label() && grammar()->isTransitive(lty.first))
+                {
+                    /// X ::= A X
+                    ECGNode* src = ecgs[lty.first]->getNode(item.src());
+                    checkPreds(newTy, src, item.dst());
+                }
+                else
+                {
+                    NodeBS diffSrcs = checkAndAddEdges(iter.second, item.dst(), newTy);
+                    for (NodeID diffSrc : diffSrcs)
+                        pushIntoWorklist(diffSrc, item.dst(), newTy);
+                }
             }
+        }
     }
 }
 
@@ -171,7 +241,7 @@ void TRFocrCFL::procPrimaryItem(CFLItem item)
     for (auto& it : *newEdgeMapPtr)
     {
         // TODO: secondary edge in -tr
-        secondaryData.addEdges(it.first, it.second, item.label());
+        secondaryData->addEdges(it.first, it.second, item.label());
         for (auto newDst : it.second)
             pushIntoWorklist(it.first, newDst, item.label(), false);
     }
@@ -186,7 +256,7 @@ NodeBS TRFocrCFL::checkAndAddEdges(NodeID src, const NodeBS& dstSet, Label lbl)
         NodeBS diffDsts;
         stat->checks += dstSet.count();
         diffDsts.intersectWithComplement(dstSet, cflData()->getSuccs(src, lbl));
-        diffDsts.intersectWithComplement(diffDsts, secondaryData.getSuccs(src, lbl));
+        diffDsts.intersectWithComplement(diffDsts, secondaryData->getSuccs(src, lbl));
         cflData()->addEdges(src, diffDsts, lbl);
         return diffDsts;
     }
@@ -202,7 +272,7 @@ NodeBS TRFocrCFL::checkAndAddEdges(const NodeBS& srcSet, NodeID dst, Label lbl)
         NodeBS diffSrcs;
         stat->checks += srcSet.count();
         diffSrcs.intersectWithComplement(srcSet, cflData()->getPreds(dst, lbl));
-        diffSrcs.intersectWithComplement(diffSrcs, secondaryData.getPreds(dst, lbl));
+        diffSrcs.intersectWithComplement(diffSrcs, secondaryData->getPreds(dst, lbl));
         cflData()->addEdges(diffSrcs, dst, lbl);
         return diffSrcs;
     }
@@ -218,21 +288,21 @@ void TRFocrCFL::countSumEdges()
 
     /// calculate summary edges
     stat->numOfSumEdges = 0;
-    for (auto it1 = cflData()->begin(); it1 != cflData()->end(); ++it1)
-        for (auto& it2 : it1->second)
+    for (NodeID src : cflData()->getSuccKeys())
+        for (auto& it2 : cflData()->getSuccs(src))
             stat->numOfSumEdges += it2.second.count();
 
     /// calculate S edges
     stat->sEdgeSet.clear();
-    for (auto& it1 : cflData()->getSuccMap())
-        for (auto& it2 : it1.second)
+    for (NodeID src : cflData()->getSuccKeys())
+        for (auto& it2 : cflData()->getSuccs(src))
             if (grammar()->isCountSymbol(it2.first.first))
-                stat->sEdgeSet[it1.first] |= it2.second;
+                stat->sEdgeSet[src] |= it2.second;
 
-    for (auto& it1 : secondaryData.getSuccMap())
-        for (auto& it2 : it1.second)
+    for (NodeID src : secondaryData->getSuccKeys())
+        for (auto& it2 : secondaryData->getSuccs(src))
             if (grammar()->isCountSymbol(it2.first.first))
-                stat->sEdgeSet[it1.first] |= it2.second;
+                stat->sEdgeSet[src] |= it2.second;
 
     for (auto& it : stat->sEdgeSet)
         it.second.reset(it.first);
@@ -10,15 +10,16 @@ using namespace SVF;
 
 void HPocrCFL::solve()
 {
-    while (!primaryList.empty())
+    while (!primaryList.empty() && !isInterrupted())
     {
         CFLItem item = primaryList.pop();
         procPrimaryItem(item);
     }
 
-    while (!isWorklistEmpty())
+    while (!isWorklistEmpty() && !isInterrupted())
     {
         CFLItem item = popFromWorklist();
+        countItem(item.label());
         processCFLItem(item);
     }
 }
@@ -0,0 +1,220 @@
+//
+// Multi-threaded standard CFL-reachability
+//
+
+#include "CFLSolver/CFLSolver.h"
+#include <chrono>
+
+using namespace SVF;
+
+
+ParStdCFL::ParStdCFL(std::string& _grammarName, std::string& _graphName) : StdCFL(_grammarName, _graphName),
+                                                                           numOfPendingItems(0)
+{
+    numOfThreads = getNumOfThreads(CFLOpt::threads());
+
+    /// a power of two, large enough to keep lock contention low
+    u32_t numOfShards = 64;
+    while (numOfShards < numOfThreads * 64)
+        numOfShards <<= 1;
+    shards = std::vector<Shard>(numOfShards);
+    queues = std::vector<ThreadQueue>(numOfThreads);
+}
+
+
+void ParStdCFL::solve()
+{
+    /// UCFL edges are not stored, so they cannot be deduplicated by the shards
+    if (CFLOpt::ucfl())
+    {
+        StdCFL::solve();
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    distributeData();
+
+    std::vector<std::thread> workers;
+    for (u32_t tid = 0; tid < numOfThreads; ++tid)
+        workers.emplace_back(&ParStdCFL::runWorker, this, tid);
+    for (std::thread& worker : workers)
+        worker.join();
+
+    collectData();
+
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    stat->wallTimeOfSolving += duration.count();
+}
+
+
+/*!
+ * Move the initial edges into shards and the initial items into thread queues
+ */
+void ParStdCFL::distributeData()
+{
+    for (NodeID src : cflData()->getSuccKeys())
+        for (auto& iter : cflData()->getSuccs(src))
+            getShard(src).data.getSuccs(src, iter.first) |= iter.second;
+
+    for (NodeID dst : cflData()->getPredKeys())
+        for (auto& iter : cflData()->getPreds(dst))
+            getShard(dst).data.getPreds(dst, iter.first) |= iter.second;
+
+    cflData()->clear();
+
+    u32_t tid = 0;
+    while (!isWorklistEmpty())
+    {
+        queues[tid].items.push_back(popFromWorklist());
+        numOfPendingItems++;
+        tid = (tid + 1) % numOfThreads;
+    }
+}
+
+
+/*!
+ * Merge shards back, so that the statistics and outputs work on cflData() as usual
+ */
+void ParStdCFL::collectData()
+{
+    for (Shard& shard : shards)
+    {
+        for (NodeID src : shard.data.getSuccKeys())
+            for (auto& iter : shard.data.getSuccs(src))
+                cflData()->addEdges(src, iter.second, iter.first);
+        shard.data.clear();
+    }
+
+    for (ThreadQueue& queue : queues)
+    {
+        stat->checks += queue.checks;
+        queue.checks = 0;
+    }
+}
+
+
+void ParStdCFL::runWorker(u32_t tid)
+{
+    CFLItem item(0, 0, Label(0, 0));
+    while (!isStopped())
+    {
+        if (popItem(tid, item))
+        {
+            processParItem(tid, item);
+            numOfPendingItems--;
+        }
+        else if (numOfPendingItems == 0)
+            return;
+        else
+            std::this_thread::yield();
+    }
+}
+
+
+/*!
+ * Pop from the back of the own queue, or steal from the front of another one
+ */
+bool ParStdCFL::popItem(u32_t tid, CFLItem& item)
+{
+    {
+        ThreadQueue& queue = queues[tid];
+        std::lock_guard<std::mutex> lock(queue.mtx);
+        if (!queue.items.empty())
+        {
+            item = queue.items.back();
+            queue.items.pop_back();
+            return true;
+        }
+    }
+
+    for (u32_t i = 1; i < numOfThreads; ++i)
+    {
+        ThreadQueue& victim = queues[(tid + i) % numOfThreads];
+        std::lock_guard<std::mutex> lock(victim.mtx);
+        if (!victim.items.empty())
+        {
+            item = victim.items.front();
+            victim.items.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void ParStdCFL::pushItem(u32_t tid, const CFLItem& item)
+{
+    numOfPendingItems++;
+    ThreadQueue& queue = queues[tid];
+    std::lock_guard<std::mutex> lock(queue.mtx);
+    queue.items.push_back(item);
+}
+
+
+/*!
+ * The new edges are derived while iterating the adjacent entries under the shard lock, and added after releasing
+ * it, as adding an edge takes the locks of the shards of its ends
+ */
+void ParStdCFL::processParItem(u32_t tid, const CFLItem& item)
+{
+    NodeID src = item.src();
+    NodeID dst = item.dst();
+    Label lbl = item.label();
+    std::vector<CFLItem>& derived = queues[tid].derived;
+
+    /// Derive edges via unary production rules
+    for (Label newTy : unarySumm(lbl))
+        if (addParEdge(tid, src, dst, newTy))
+            pushItem(tid, CFLItem(src, dst, newTy));
+
+    /// Derive edges via binary production rules
+    //@{
+    derived.clear();
+    {
+        Shard& shard = getShard(dst);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        for (CFGSymbTy rSymb : grammar()->getRightSymbols(lbl.first))
+            for (auto& iter : shard.data.getSymbSuccs(dst, rSymb))
+                for (Label newTy : binarySumm(lbl, iter.first))
+                    for (NodeID newDst : iter.second)
+                        derived.emplace_back(src, newDst, newTy);
+    }
+    {
+        Shard& shard = getShard(src);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        for (CFGSymbTy lSymb : grammar()->getLeftSymbols(lbl.first))
+            for (auto& iter : shard.data.getSymbPreds(src, lSymb))
+                for (Label newTy : binarySumm(iter.first, lbl))
+                    for (NodeID newSrc : iter.second)
+                        derived.emplace_back(newSrc, dst, newTy);
+    }
+    for (const CFLItem& newItem : derived)
+        if (addParEdge(tid, newItem.src(), newItem.dst(), newItem.label()))
+            pushItem(tid, newItem);
+    //@}
+}
+
+
+/*!
+ * The thread storing the succ direction first owns the new edge
+ */
+bool ParStdCFL::addParEdge(u32_t tid, NodeID src, NodeID dst, Label lbl)
+{
+    if (!lbl.first)
+        return false;
+
+    queues[tid].checks++;
+    {
+        Shard& shard = getShard(src);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        if (!shard.data.getSuccs(src, lbl).test_and_set(dst))
+            return false;
+    }
+    {
+        Shard& shard = getShard(dst);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        shard.data.getPreds(dst, lbl).set(src);
+    }
+    return true;
+}
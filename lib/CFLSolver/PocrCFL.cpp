@@ -9,19 +9,20 @@ using namespace SVF;
 
 void PocrCFL::initSolver()
 {
-    StdCFL::initSolver();
-
-    /// Init ptrees and strees for each node
+    /// Trees are created before a saved state is loaded into them
     for (auto lbl : grammar()->transitiveSymbols)
     {
         ptrees[lbl] = new HybridData();
         strees[lbl] = new HybridData();
     }
-    for (auto it = graph()->begin(); it != graph()->end(); ++it)
+
+    StdCFL::initSolver();
+
+    /// Init ptrees and strees for each node
+    for (NodeID nId : getNewInputNodes())
     {
         for (auto lbl : grammar()->transitiveSymbols)
         {
-            NodeID nId = it->first;
             ptrees[lbl]->addInd(nId, nId);
             strees[lbl]->addInd(nId, nId);
         }
@@ -36,57 +37,131 @@ void PocrCFL::initSolver()
     }
     for (auto lbl : transitiveSymbols)
         grammar()->binaryRules[std::make_pair(lbl, lbl)].erase(lbl);
+    grammar()->compileRules();
+}
+
+
+/*!
+ * A section for each transitive symbol, with its predecessor and successor trees
+ */
+void PocrCFL::saveState(StateWriter& writer)
+{
+    StdCFL::saveState(writer);
+    for (auto lbl : grammar()->transitiveSymbols)
+    {
+        writer.beginSection(StateWriter::Trees);
+        writer.write(lbl);
+        writer.write((u32_t) 2);
+        writer.writeTrees(*ptrees[lbl]);
+        writer.writeTrees(*strees[lbl]);
+        writer.endSection();
+    }
+}
+
+
+void PocrCFL::loadState(StateReader& reader)
+{
+    StdCFL::loadState(reader);
+    for (u32_t i = 0; i < grammar()->transitiveSymbols.size() && reader.good(); ++i)
+    {
+        if (!reader.openSection(StateWriter::Trees, i))
+            reader.setFailed();
+        CFGSymbTy lbl = reader.read<CFGSymbTy>();
+        if (!grammar()->isTransitive(lbl) || reader.read<u32_t>() != 2)
+        {
+            reader.setFailed();
+            break;
+        }
+        reader.readTrees(*ptrees[lbl]);
+        reader.readTrees(*strees[lbl]);
+    }
 }
 
 
 void PocrCFL::processCFLItem(CFLItem item)
+{
+    if (profiler)
+        procItem<true>(item);
+    else
+        procItem<false>(item);
+}
+
+
+/*!
+ * Primary transitive items are profiled as X ::= X X, with the checks in the spanning trees as derivations
+ */
+template<bool Profiled>
+void PocrCFL::procItem(CFLItem item)
 {
     /// Process primary items
     if (grammar()->isTransitive(item.label().first) && isPrimary(item))
     {
+        CFGSymbTy symb = item.label().first;
+        RuleProbe<Profiled> probe(profiler, symb, symb, symb);
+        u64_t treeChecks = Profiled ? ptrees[symb]->checks + strees[symb]->checks : 0;
+        CFLItem secondary(item.src(), item.dst(), item.label(), false);
+        bool isQueued = Profiled && isInWorklist(secondary);
         procPrimaryItem(item);
+        probe.addDerivations(Profiled ? ptrees[symb]->checks + strees[symb]->checks - treeChecks : 0);
+        /// the item itself is pushed again as a secondary item
+        probe.discountNewEdges(Profiled && !isQueued && isInWorklist(secondary));
         return;
     }
 
     /// Process other items
     for (Label newTy : unarySumm(item.label()))
+    {
+        RuleProbe<Profiled> probe(profiler, newTy.first, item.label().first);
         if (checkAndAddEdge(item.src(), item.dst(), newTy))
             pushIntoWorklist(item.src(), item.dst(), newTy);
+    }
 
-    for (auto& iter : cflData()->getSuccs(item.dst()))
+    for (CFGSymbTy rSymb : grammar()->getRightSymbols(item.label().first))
     {
-        Label rty = iter.first;
-        for (Label newTy : binarySumm(item.label(), rty))
-            if (newTy == item.label() && grammar()->isTransitive(rty.first))
-            {
-                /// X ::= X A
-                TreeNode* dst = strees[rty.first]->getNode(item.dst(), item.dst());
-                checkStree(newTy, item.src(), dst);
-            }
-            else
+        for (auto& iter : cflData()->getSymbSuccs(item.dst(), rSymb))
+        {
+            Label rty = iter.first;
+            for (Label newTy : binarySumm(item.label(), rty))
             {
-                NodeBS diffDsts = checkAndAddEdges(item.src(), iter.second, newTy);
-                for (NodeID diffDst : diffDsts)
-                    pushIntoWorklist(item.src(), diffDst, newTy);
+                RuleProbe<Profiled> probe(profiler, newTy.first, item.label().first, rSymb);
+                if (newTy == item.label() && grammar()->isTransitive(rty.first))
+                {
+                    /// X ::= X A
+                    TreeNode* dst = strees[rty.first]->getNode(item.dst(), item.dst());
+                    checkStree(newTy, item.src(), dst);
+                }
+                else
+                {
+                    NodeBS diffDsts = checkAndAddEdges(item.src(), iter.second, newTy);
+                    for (NodeID diffDst : diffDsts)
+                        pushIntoWorklist(item.src(), diffDst, newTy);
+                }
             }
+        }
     }
 
-    for (auto& iter : cflData()->getPreds(item.src()))
+    for (CFGSymbTy lSymb : grammar()->getLeftSymbols(item.label().first))
     {
-        Label lty = iter.first;
-        for (Label newTy : binarySumm(lty, item.label()))
-            if (newTy == item.label() && grammar()->isTransitive(lty.first))
-            {
-                /// X ::= A X
-                TreeNode* src = ptrees[lty.first]->getNode(item.src(), item.src());
-                checkPtree(newTy, src, item.dst());
-            }
-            else
+        for (auto& iter : cflData()->getSymbPreds(item.src(), lSymb))
+        {
+            Label lty = iter.first;
+            for (Label newTy : binarySumm(lty, item.label()))
             {
-                NodeBS diffSrcs = checkAndAddEdges(iter.second, item.dst(), newTy);
-                for (NodeID diffSrc : diffSrcs)
-                    pushIntoWorklist(diffSrc, item.dst(), newTy);
+                RuleProbe<Profiled> probe(profiler, newTy.first, lSymb, item.label().first);
+                if (newTy == item.label() && grammar()->isTransitive(lty.first))
+                {
+                    /// X ::= A X
+                    TreeNode* src = ptrees[lty.first]->getNode(item.src(), item.src());
+                    checkPtree(newTy, src, item.dst());
+                }
+                else
+                {
+                    NodeBS diffSrcs = checkAndAddEdges(iter.second, item.dst(), newTy);
+                    for (NodeID diffSrc : diffSrcs)
+                        pushIntoWorklist(diffSrc, item.dst(), newTy);
+                }
             }
+        }
     }
 }
 
@@ -0,0 +1,125 @@
+//
+// Progress telemetry of solving
+//
+
+#include "CFLSolver/ProgressSampler.h"
+#include "CFLSolver/StatSink.h"
+#include <Util/SVFUtil.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+using namespace SVF;
+
+const u32_t SolverProgress::publishInterval;
+const u32_t SolverProgress::maxSymbols;
+
+static double getWallTime()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+ProgressSampler::ProgressSampler(const Map<CFGSymbTy, std::string>& _symbNames, u32_t _interval)
+        : symbNames(_symbNames), interval(_interval), stopped(false), startTime(0), lastTime(0), lastEdges(0)
+{
+    for (u32_t i = 0; i < SolverProgress::maxSymbols; ++i)
+        lastSymbItems[i] = 0;
+}
+
+
+/*!
+ * No thread is started for a zero interval, which would sample without waiting
+ */
+void ProgressSampler::start()
+{
+    if (interval == 0)
+        return;
+    startTime = lastTime = getWallTime();
+    th = std::thread(&ProgressSampler::run, this);
+}
+
+
+void ProgressSampler::stop()
+{
+    if (!th.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopped = true;
+    }
+    cv.notify_one();
+    th.join();
+    sample();
+}
+
+
+void ProgressSampler::run()
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!cv.wait_for(lock, std::chrono::seconds(interval), [this]()
+    { return stopped; }))
+        sample();
+}
+
+
+/*!
+ * The three labels of the most items in the interval, with their shares of the items
+ */
+void ProgressSampler::sample()
+{
+    double now = getWallTime();
+    u64_t items = progress.numOfItems.load(std::memory_order_relaxed);
+    u64_t worklistSize = progress.worklistSize.load(std::memory_order_relaxed);
+    u64_t checks = progress.checks.load(std::memory_order_relaxed);
+    u64_t edges = items + worklistSize;
+    double rate = now > lastTime ? (edges - lastEdges) / (now - lastTime) : 0;
+
+    std::vector<std::pair<u64_t, CFGSymbTy>> active;
+    u64_t intervalItems = 0;
+    for (u32_t i = 0; i < SolverProgress::maxSymbols; ++i)
+    {
+        u64_t symbItems = progress.itemsOfSymbols[i].load(std::memory_order_relaxed);
+        if (symbItems > lastSymbItems[i])
+        {
+            active.push_back(std::make_pair(symbItems - lastSymbItems[i], i));
+            intervalItems += symbItems - lastSymbItems[i];
+        }
+        lastSymbItems[i] = symbItems;
+    }
+    std::sort(active.begin(), active.end(), std::greater<std::pair<u64_t, CFGSymbTy>>());
+    active.resize(std::min<size_t>(active.size(), 3));
+
+    auto symbName = [this](CFGSymbTy symb)
+    {
+        auto it = symbNames.find(symb);
+        return it == symbNames.end() ? std::string("other") : it->second;
+    };
+
+    u32_t vmrss = 0, vmsize = 0;
+    SVFUtil::getMemoryUsageKB(&vmrss, &vmsize);
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (StatSink::getFormat() == StatSink::JSON)
+    {
+        out << "{\"elapsed\": " << now - startTime << ", \"worklist\": " << worklistSize << ", \"edges\": " << edges
+            << ", \"edgesPerSec\": " << rate << ", \"checks\": " << checks << ", \"rssInKB\": " << vmrss
+            << ", \"active\": {";
+        for (u32_t i = 0; i < active.size(); ++i)
+            out << (i ? ", " : "") << "\"" << symbName(active[i].second) << "\": " << active[i].first;
+        out << "}}";
+    }
+    else
+    {
+        out << "[progress] " << now - startTime << "s worklist " << worklistSize << " edges " << edges << " ("
+            << rate << "/s) checks " << checks << " rss " << vmrss / 1024.0 << "MB active";
+        for (auto& iter : active)
+            out << " " << symbName(iter.second) << ":" << 100.0 * iter.first / intervalItems << "%";
+    }
+    std::cerr << out.str() << std::endl;
+
+    lastTime = now;
+    lastEdges = edges;
+}
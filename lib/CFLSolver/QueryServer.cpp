@@ -0,0 +1,537 @@
+//
+// Serving reachability queries over a Unix socket
+//
+
+#include "CFLSolver/QueryServer.h"
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <thread>
+
+using namespace SVF;
+
+
+bool QueryChannel::readBytes(void* dst, size_t size)
+{
+    char* out = (char*) dst;
+    while (size)
+    {
+        if (inPos == inEnd)
+        {
+            ssize_t num = ::recv(fd, inBuf.data(), inBuf.size(), 0);
+            if (num < 0 && errno == EINTR)
+                continue;
+            if (num <= 0)
+                return false;
+            inPos = 0;
+            inEnd = num;
+        }
+        size_t len = std::min(size, inEnd - inPos);
+        memcpy(out, inBuf.data() + inPos, len);
+        inPos += len;
+        out += len;
+        size -= len;
+    }
+    return true;
+}
+
+
+/*!
+ * A closed peer fails the send rather than raising SIGPIPE
+ */
+bool QueryChannel::flush()
+{
+    size_t pos = 0;
+    while (pos < outBuf.size())
+    {
+        ssize_t num = ::send(fd, outBuf.data() + pos, outBuf.size() - pos, MSG_NOSIGNAL);
+        if (num < 0 && errno == EINTR)
+            continue;
+        if (num <= 0)
+        {
+            outBuf.clear();
+            return false;
+        }
+        pos += num;
+    }
+    outBuf.clear();
+    return true;
+}
+
+
+/// ------------------- Query server ----------------------
+
+QueryServer::~QueryServer()
+{
+    delete state;
+}
+
+
+void QueryServer::setData(CFLData* _data, const NodeBS& nodes)
+{
+    data = _data;
+    int lastNode = std::max(nodes.find_last(), data->getSuccKeys().find_last());
+    numOfNodes = lastNode + 1;
+}
+
+
+void QueryServer::addTrees(CFGSymbTy symb, HybridData* trees)
+{
+    treeMap[symb] = trees;
+}
+
+
+void QueryServer::addSymbols(const Map<CFGSymbTy, std::string>& symbMap)
+{
+    for (auto& iter : symbMap)
+    {
+        symbols[iter.second] = iter.first;
+        symbIds.insert(iter.first);
+    }
+}
+
+
+/*!
+ * Only successor entries are indexed, as queries go from srcs to dsts.
+ * A section of a single tree holds the edges of its symbol, which are not in the data,
+ * while predecessor and successor trees only index edges of the data
+ */
+bool QueryServer::loadState(const std::string& fname, const std::string& kindPrefix)
+{
+    state = new StateReader(fname);
+    StateReader& reader = *state;
+    Map<CFGSymbTy, std::string> symbMap;
+    NodeBS nodes;
+    if (!reader.good() || reader.getKind().compare(0, kindPrefix.size(), kindPrefix) != 0
+        || !reader.openSection(StateWriter::Symbols))
+        return false;
+    reader.readSymbols(symbMap);
+    addSymbols(symbMap);
+    if (reader.openSection(StateWriter::Nodes))
+        reader.readNodeBS(nodes);
+
+    if (!reader.openSection(StateWriter::Data))
+        return false;
+    stateDataEnd = reader.getEnd();
+    u64_t numOfKeys = reader.readVarint();
+    NodeID key = 0;
+    for (u64_t i = 0; i < numOfKeys && reader.good(); ++i)
+    {
+        key += reader.readVarint();
+        stateSuccs.resize(key + 1, nullptr);
+        stateSuccs[key] = reader.getPos();
+        for (u64_t numOfEntries = reader.readVarint(); numOfEntries && reader.good(); --numOfEntries)
+        {
+            reader.readVarint();
+            reader.readVarint();
+            reader.skipNodeBS();
+        }
+    }
+    int lastNode = std::max(nodes.find_last(), (int) stateSuccs.size() - 1);
+    numOfNodes = lastNode + 1;
+
+    for (u32_t i = 0; reader.openSection(StateWriter::Trees, i) && reader.good(); ++i)
+    {
+        CFGSymbTy symb = reader.read<CFGSymbTy>();
+        if (reader.read<u32_t>() != 1)
+            continue;
+        StateTrees& trees = stateTrees[symb];
+        trees.end = reader.getEnd();
+        u64_t numOfRoots = reader.readVarint();
+        NodeID root = 0;
+        for (u64_t j = 0; j < numOfRoots && reader.good(); ++j)
+        {
+            root += reader.readVarint();
+            trees.roots[root] = reader.getPos();
+            reader.readTreeNodes(nullptr);
+        }
+    }
+    return reader.good();
+}
+
+
+bool QueryServer::setDefaultSymbol(const std::string& name)
+{
+    auto it = symbols.find(name);
+    if (it == symbols.end())
+        return false;
+    defaultSymb = it->second;
+    return true;
+}
+
+
+/*!
+ * test() of a sparse bit vector moves its cached element iterator, which races between readers,
+ * so membership is checked by intersects() with a thread-local single-bit set, which only reads
+ */
+bool QueryServer::hasEdge(NodeID src, NodeID dst, CFGSymbTy symb) const
+{
+    if (state)
+        return hasStateEdge(src, dst, symb);
+
+    auto treeIt = treeMap.find(symb);
+    if (treeIt != treeMap.end())
+    {
+        auto it = treeIt->second->indMap.find(dst);
+        return it != treeIt->second->indMap.end() && it->second.find(src) != it->second.end();
+    }
+
+    static thread_local NodeBS probe;
+    probe.clear();
+    probe.set(dst);
+    for (auto& iter : data->getSymbSuccs(src, symb))
+        if (iter.second.intersects(probe))
+            return true;
+    return false;
+}
+
+
+/*!
+ * The dsts of a symbol in spanning trees are the nodes of the tree of src
+ */
+void QueryServer::getDsts(NodeID src, CFGSymbTy symb, NodeBS& dsts) const
+{
+    if (state)
+    {
+        getStateDsts(src, symb, dsts);
+        return;
+    }
+
+    auto treeIt = treeMap.find(symb);
+    if (treeIt == treeMap.end())
+    {
+        for (auto& iter : data->getSymbSuccs(src, symb))
+            dsts |= iter.second;
+        return;
+    }
+
+    auto it = treeIt->second->indMap.find(src);
+    if (it == treeIt->second->indMap.end())
+        return;
+    auto rootIt = it->second.find(src);
+    if (rootIt == it->second.end())
+        return;
+    std::vector<const HybridData::TreeNode*> nodeStack = {rootIt->second};
+    while (!nodeStack.empty())
+    {
+        const HybridData::TreeNode* node = nodeStack.back();
+        nodeStack.pop_back();
+        dsts.set(node->id);
+        for (const HybridData::TreeNode* child : node->children)
+            nodeStack.push_back(child);
+    }
+}
+
+
+/*!
+ * Each query reads the mapped state by its own reader, so that queries are served concurrently
+ */
+bool QueryServer::hasStateEdge(NodeID src, NodeID dst, CFGSymbTy symb) const
+{
+    auto treeIt = stateTrees.find(symb);
+    if (treeIt != stateTrees.end())
+    {
+        NodeBS dsts;
+        getStateDsts(src, symb, dsts);
+        return dsts.test(dst);
+    }
+
+    if (src >= stateSuccs.size() || !stateSuccs[src])
+        return false;
+    StateReader reader(stateSuccs[src], stateDataEnd);
+    for (u64_t numOfEntries = reader.readVarint(); numOfEntries && reader.good(); --numOfEntries)
+    {
+        bool isSymb = reader.readVarint() == symb;
+        reader.readVarint();
+        if (reader.findInNodeBS(dst) && isSymb)
+            return true;
+    }
+    return false;
+}
+
+
+void QueryServer::getStateDsts(NodeID src, CFGSymbTy symb, NodeBS& dsts) const
+{
+    auto treeIt = stateTrees.find(symb);
+    if (treeIt != stateTrees.end())
+    {
+        auto rootIt = treeIt->second.roots.find(src);
+        if (rootIt == treeIt->second.roots.end())
+            return;
+        dsts.set(src);
+        StateReader reader(rootIt->second, treeIt->second.end);
+        reader.readTreeNodes(&dsts);
+        return;
+    }
+
+    if (src >= stateSuccs.size() || !stateSuccs[src])
+        return;
+    StateReader reader(stateSuccs[src], stateDataEnd);
+    for (u64_t numOfEntries = reader.readVarint(); numOfEntries && reader.good(); --numOfEntries)
+    {
+        bool isSymb = reader.readVarint() == symb;
+        reader.readVarint();
+        if (isSymb)
+            reader.readNodeBS(dsts);
+        else
+            reader.skipNodeBS();
+    }
+}
+
+
+/*!
+ * The threads accept connections on the same socket, a stale socket of an earlier server is replaced
+ */
+bool QueryServer::serve(const std::string& sockPath, u32_t numOfThreads)
+{
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (sockPath.size() >= sizeof(addr.sun_path))
+    {
+        std::cout << "socket path too long: " << sockPath << std::endl;
+        return false;
+    }
+    memcpy(addr.sun_path, sockPath.data(), sockPath.size());
+
+    struct stat st;
+    if (lstat(sockPath.c_str(), &st) == 0 && S_ISSOCK(st.st_mode))
+        unlink(sockPath.c_str());
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0 || ::bind(listenFd, (sockaddr*) &addr, sizeof(addr)) != 0 || ::listen(listenFd, SOMAXCONN) != 0)
+    {
+        std::cout << "error opening socket " << sockPath << ": " << strerror(errno) << std::endl;
+        if (listenFd >= 0)
+            ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    std::cout << "serving queries on " << sockPath << std::endl;
+
+    std::vector<std::thread> threads;
+    for (u32_t i = 0; i < numOfThreads; ++i)
+        threads.emplace_back(&QueryServer::acceptConnections, this);
+    for (std::thread& th : threads)
+        th.join();
+
+    ::close(listenFd);
+    listenFd = -1;
+    unlink(sockPath.c_str());
+    return true;
+}
+
+
+/*!
+ * A shutdown request shuts the listening socket down, which wakes up the other threads
+ */
+void QueryServer::acceptConnections()
+{
+    while (!stopped)
+    {
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd < 0)
+        {
+            if (errno == EINTR && !stopped)
+                continue;
+            break;
+        }
+
+        QueryChannel channel(fd);
+        serveConnection(channel);
+        ::close(fd);
+    }
+}
+
+
+void QueryServer::serveConnection(QueryChannel& channel)
+{
+    u32_t op, symb, count;
+    while (channel.readU32(op) && channel.readU32(symb) && channel.readU32(count))
+    {
+        if (!symb)
+            symb = defaultSymb;
+        bool isKnown = symbIds.find(symb) != symbIds.end();
+
+        switch (op)
+        {
+        case Point:
+        {
+            channel.writeU32(isKnown ? Ok : UnknownSymbol);
+            for (u32_t i = 0; i < count; ++i)
+            {
+                u32_t src, dst;
+                if (!channel.readU32(src) || !channel.readU32(dst))
+                    return;
+                if (!isKnown)
+                    continue;
+                u8_t res = hasEdge(src, dst, symb);
+                channel.writeBytes(&res, sizeof(res));
+            }
+            break;
+        }
+        case Row:
+        {
+            channel.writeU32(isKnown ? Ok : UnknownSymbol);
+            for (u32_t i = 0; i < count; ++i)
+            {
+                u32_t src;
+                if (!channel.readU32(src))
+                    return;
+                if (!isKnown)
+                    continue;
+                NodeBS dsts;
+                getDsts(src, symb, dsts);
+                channel.writeU32(dsts.count());
+                for (NodeID dst : dsts)
+                    channel.writeU32(dst);
+            }
+            break;
+        }
+        case Symbol:
+        {
+            std::string name(std::min<u32_t>(count, 4096), '\0');
+            if (count > name.size() || !channel.readBytes(&name[0], name.size()))
+            {
+                channel.writeU32(BadRequest);
+                channel.flush();
+                return;
+            }
+            auto it = symbols.find(name);
+            channel.writeU32(it == symbols.end() ? UnknownSymbol : Ok);
+            if (it != symbols.end())
+                channel.writeU32(it->second);
+            break;
+        }
+        case Info:
+            channel.writeU32(Ok);
+            channel.writeU32(defaultSymb);
+            channel.writeU32(numOfNodes);
+            break;
+        case Shutdown:
+            channel.writeU32(Ok);
+            channel.flush();
+            stopped = true;
+            ::shutdown(listenFd, SHUT_RDWR);
+            return;
+        default:
+            channel.writeU32(BadRequest);
+            channel.flush();
+            return;
+        }
+
+        if (!channel.flush())
+            return;
+    }
+}
+
+
+/// ------------------- Query client ----------------------
+
+bool QueryClient::connect(const std::string& sockPath)
+{
+    close();
+
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (sockPath.size() >= sizeof(addr.sun_path))
+        return false;
+    memcpy(addr.sun_path, sockPath.data(), sockPath.size());
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return false;
+    if (::connect(fd, (sockaddr*) &addr, sizeof(addr)) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    channel = new QueryChannel(fd);
+    return true;
+}
+
+
+void QueryClient::close()
+{
+    if (!channel)
+        return;
+    ::close(channel->getFd());
+    delete channel;
+    channel = nullptr;
+}
+
+
+void QueryClient::sendHeader(u32_t op, CFGSymbTy symb, u32_t count)
+{
+    channel->writeU32(op);
+    channel->writeU32(symb);
+    channel->writeU32(count);
+}
+
+
+bool QueryClient::receiveStatus()
+{
+    u32_t status;
+    return channel->flush() && channel->readU32(status) && status == QueryServer::Ok;
+}
+
+
+bool QueryClient::info(CFGSymbTy& defaultSymb, NodeID& numOfNodes)
+{
+    sendHeader(QueryServer::Info, 0, 0);
+    return receiveStatus() && channel->readU32(defaultSymb) && channel->readU32(numOfNodes);
+}
+
+
+bool QueryClient::lookupSymbol(const std::string& name, CFGSymbTy& symb)
+{
+    sendHeader(QueryServer::Symbol, 0, name.size());
+    channel->writeBytes(name.data(), name.size());
+    return receiveStatus() && channel->readU32(symb);
+}
+
+
+bool QueryClient::queryPoints(CFGSymbTy symb, const std::vector<std::pair<NodeID, NodeID>>& pairs,
+                              std::vector<u8_t>& results)
+{
+    sendHeader(QueryServer::Point, symb, pairs.size());
+    for (auto& pair : pairs)
+    {
+        channel->writeU32(pair.first);
+        channel->writeU32(pair.second);
+    }
+    results.resize(pairs.size());
+    return receiveStatus() && channel->readBytes(results.data(), results.size());
+}
+
+
+bool QueryClient::queryRows(CFGSymbTy symb, const std::vector<NodeID>& srcs, std::vector<std::vector<NodeID>>& rows)
+{
+    sendHeader(QueryServer::Row, symb, srcs.size());
+    for (NodeID src : srcs)
+        channel->writeU32(src);
+    if (!receiveStatus())
+        return false;
+
+    rows.resize(srcs.size());
+    for (std::vector<NodeID>& row : rows)
+    {
+        u32_t num;
+        if (!channel->readU32(num))
+            return false;
+        row.resize(num);
+        if (num && !channel->readBytes(row.data(), num * sizeof(NodeID)))
+            return false;
+    }
+    return true;
+}
+
+
+bool QueryClient::shutdown()
+{
+    sendHeader(QueryServer::Shutdown, 0, 0);
+    return receiveStatus();
+}
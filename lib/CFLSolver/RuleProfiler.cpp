@@ -0,0 +1,99 @@
+//
+// Per-production profiling of CFL solvers
+//
+
+#include "CFLSolver/RuleProfiler.h"
+#include <iomanip>
+
+using namespace SVF;
+
+
+RuleProfiler::RuleProfiler(CFG* _grammar, const u64_t* _checks, const CFLWorkList* _worklist)
+        : grammar(_grammar), numOfSlots(_grammar->numOfSymbols + 1), checks(_checks), worklist(_worklist)
+{
+    ruleStats.resize((u64_t) numOfSlots * numOfSlots * numOfSlots);
+}
+
+
+std::string RuleProfiler::getRuleString(CFGSymbTy lhs, CFGSymbTy lRhs, CFGSymbTy rRhs)
+{
+    std::string str = grammar->getSymbolString(lhs) + " ::= " + grammar->getSymbolString(lRhs);
+    if (rRhs)
+        str += " " + grammar->getSymbolString(rRhs);
+    return str;
+}
+
+
+/*!
+ * Table indices of the fired productions, the most time-consuming first
+ */
+void RuleProfiler::getFiredRules(std::vector<u32_t>& rules)
+{
+    for (u32_t i = 0; i < ruleStats.size(); ++i)
+        if (ruleStats[i].firings)
+            rules.push_back(i);
+    std::sort(rules.begin(), rules.end(), [this](u32_t a, u32_t b)
+    {
+        if (ruleStats[a].nanoSecs != ruleStats[b].nanoSecs)
+            return ruleStats[a].nanoSecs > ruleStats[b].nanoSecs;
+        return ruleStats[a].derivations > ruleStats[b].derivations;
+    });
+}
+
+
+void RuleProfiler::printReport(double solvingTime)
+{
+    std::vector<u32_t> rules;
+    getFiredRules(rules);
+
+    u32_t ruleWidth = 12;
+    for (u32_t i : rules)
+        ruleWidth = std::max<u32_t>(ruleWidth, getRuleString(i / numOfSlots / numOfSlots, i / numOfSlots % numOfSlots,
+                                                             i % numOfSlots).size() + 2);
+    const int field_width = 14;
+
+    std::cout << "\n*********Production profile*********\n";
+    std::cout.flags(std::ios::left);
+    std::cout << std::setw(ruleWidth) << "Production" << std::setw(field_width) << "Firings"
+              << std::setw(field_width) << "Derivations" << std::setw(field_width) << "NewEdges"
+              << std::setw(field_width) << "Redundant" << std::setw(field_width) << "Time" << "Time%\n";
+    for (u32_t i : rules)
+    {
+        const RuleStat& rs = ruleStats[i];
+        double secs = rs.nanoSecs / 1e9;
+        std::cout << std::setw(ruleWidth)
+                  << getRuleString(i / numOfSlots / numOfSlots, i / numOfSlots % numOfSlots, i % numOfSlots)
+                  << std::setw(field_width) << rs.firings << std::setw(field_width) << rs.derivations
+                  << std::setw(field_width) << rs.newEdges
+                  << std::setw(field_width) << (rs.derivations > rs.newEdges ? rs.derivations - rs.newEdges : 0)
+                  << std::setw(field_width) << secs
+                  << (solvingTime > 0 ? 100 * secs / solvingTime : 0) << "\n";
+    }
+    std::cout.flush();
+}
+
+
+void RuleProfiler::writeCSV(const std::string& fname)
+{
+    std::ofstream outFile(fname, std::ios::out);
+    if (!outFile)
+    {
+        std::cout << "error opening " << fname << std::endl;
+        return;
+    }
+
+    std::vector<u32_t> rules;
+    getFiredRules(rules);
+    outFile << "lhs,left_rhs,right_rhs,firings,derivations,new_edges,redundant,time_s\n";
+    for (u32_t i : rules)
+    {
+        const RuleStat& rs = ruleStats[i];
+        CFGSymbTy rRhs = i % numOfSlots;
+        outFile << grammar->getSymbolString(i / numOfSlots / numOfSlots) << ','
+                << grammar->getSymbolString(i / numOfSlots % numOfSlots) << ','
+                << (rRhs ? grammar->getSymbolString(rRhs) : "") << ','
+                << rs.firings << ',' << rs.derivations << ',' << rs.newEdges << ','
+                << (rs.derivations > rs.newEdges ? rs.derivations - rs.newEdges : 0) << ','
+                << rs.nanoSecs / 1e9 << '\n';
+    }
+}
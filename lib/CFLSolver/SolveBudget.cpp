@@ -0,0 +1,71 @@
+//
+// Wall-clock and memory budgets of solving
+//
+
+#include "CFLSolver/SolveBudget.h"
+#include <Util/SVFUtil.h>
+#include <chrono>
+
+using namespace SVF;
+
+
+void SolveBudget::start()
+{
+    if (timeBudget || rssBudget)
+        th = std::thread(&SolveBudget::run, this);
+}
+
+
+void SolveBudget::stop()
+{
+    if (!th.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopped = true;
+    }
+    cv.notify_one();
+    th.join();
+}
+
+
+/*!
+ * The budgets are not watched any more once one of them runs out
+ */
+void SolveBudget::run()
+{
+    auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!cv.wait_for(lock, std::chrono::seconds(1), [this]()
+    { return stopped; }))
+    {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (timeBudget && elapsed.count() >= timeBudget)
+        {
+            exceeded.store(Time, std::memory_order_relaxed);
+            return;
+        }
+
+        u32_t vmrss = 0, vmsize = 0;
+        SVFUtil::getMemoryUsageKB(&vmrss, &vmsize);
+        if (rssBudget && vmrss / 1024 >= rssBudget)
+        {
+            exceeded.store(Memory, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+
+std::string SolveBudget::getReason() const
+{
+    switch (getExceeded())
+    {
+    case Time:
+        return "the time budget of " + std::to_string(timeBudget) + "s ran out";
+    case Memory:
+        return "the memory budget of " + std::to_string(rssBudget) + "MB ran out";
+    default:
+        return "";
+    }
+}
@@ -0,0 +1,193 @@
+//
+// Machine-readable statistics of analyses
+//
+
+#include "CFLSolver/StatSink.h"
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <iomanip>
+#include <sstream>
+
+using namespace SVF;
+
+std::string StatSink::commandLine;
+
+
+StatSink::FormatTy StatSink::getFormat()
+{
+    if (CFLOpt::statFormat() == "json")
+        return JSON;
+    if (CFLOpt::statFormat() == "csv")
+        return CSV;
+    return Text;
+}
+
+
+void StatSink::setCommandLine(int argc, char** argv)
+{
+    commandLine.clear();
+    for (int i = 0; i < argc; ++i)
+        commandLine += (i ? " " : "") + std::string(argv[i]);
+}
+
+
+void StatSink::add(const std::string& section, const std::string& name, u64_t val)
+{
+    entries.push_back({section, name, std::to_string(val), false});
+}
+
+
+void StatSink::add(const std::string& section, const std::string& name, double val)
+{
+    std::ostringstream str;
+    str << std::setprecision(6) << val;
+    entries.push_back({section, name, str.str(), false});
+}
+
+
+void StatSink::add(const std::string& section, const std::string& name, const std::string& val)
+{
+    entries.push_back({section, name, val, true});
+}
+
+
+/*!
+ * Files are hashed by 64-bit words (and the bytes of the tail) with multiply-xorshift mixing,
+ * which tells apart inputs of the same name and size at the speed of reading them
+ */
+void StatSink::addIdentity(const std::vector<std::pair<std::string, std::string>>& inputs)
+{
+    add("input", "command", commandLine);
+    for (auto& input : inputs)
+    {
+        add("input", input.first, input.second);
+
+        void* base = nullptr;
+        size_t length = 0;
+        if (!mapFile(input.second, base, length))
+            continue;
+        u64_t hash = 0xcbf29ce484222325ULL ^ length;
+        const char* pos = (const char*) base;
+        size_t i = 0;
+        for (; i + sizeof(u64_t) <= length; i += sizeof(u64_t))
+        {
+            u64_t word;
+            memcpy(&word, pos + i, sizeof(word));
+            hash = (hash ^ word) * 0x100000001b3ULL;
+            hash ^= hash >> 29;
+        }
+        for (; i < length; ++i)
+            hash = (hash ^ (u8_t) pos[i]) * 0x100000001b3ULL;
+        munmap(base, length);
+
+        std::ostringstream hex;
+        hex << std::hex << std::setw(16) << std::setfill('0') << hash;
+        add("input", input.first + "Bytes", (u64_t) length);
+        add("input", input.first + "Hash", hex.str());
+    }
+}
+
+
+void StatSink::addPeakMemory()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        add("memory", "PeakRssInKB", (u64_t) usage.ru_maxrss);
+}
+
+
+void StatSink::write()
+{
+    FormatTy format = getFormat();
+    if (format == Text)
+        return;
+
+    std::ofstream outFile;
+    if (!CFLOpt::statFile().empty())
+    {
+        outFile.open(CFLOpt::statFile(), std::ios::out | std::ios::trunc);
+        if (!outFile)
+        {
+            std::cout << "error opening " << CFLOpt::statFile() << std::endl;
+            return;
+        }
+    }
+    std::ostream& out = outFile.is_open() ? outFile : std::cout;
+    if (format == JSON)
+        writeJSON(out);
+    else
+        writeCSV(out);
+    out.flush();
+}
+
+
+std::string StatSink::escape(const std::string& str)
+{
+    std::string res;
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+            res += '\\';
+        if ((u8_t) c < 0x20)
+        {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            res += buf;
+            continue;
+        }
+        res += c;
+    }
+    return res;
+}
+
+
+/*!
+ * Sections in the order of their first entries
+ */
+void StatSink::writeJSON(std::ostream& out)
+{
+    std::vector<std::string> sections;
+    for (const Entry& entry : entries)
+        if (std::find(sections.begin(), sections.end(), entry.section) == sections.end())
+            sections.push_back(entry.section);
+
+    out << "{";
+    for (u32_t i = 0; i < sections.size(); ++i)
+    {
+        out << (i ? ",\n" : "\n") << "  \"" << escape(sections[i]) << "\": {";
+        bool isFirst = true;
+        for (const Entry& entry : entries)
+        {
+            if (entry.section != sections[i])
+                continue;
+            out << (isFirst ? "\n" : ",\n") << "    \"" << escape(entry.name) << "\": ";
+            if (entry.isString)
+                out << "\"" << escape(entry.value) << "\"";
+            else
+                out << entry.value;
+            isFirst = false;
+        }
+        out << "\n  }";
+    }
+    out << "\n}\n";
+}
+
+
+void StatSink::writeCSV(std::ostream& out)
+{
+    out << "section,name,value\n";
+    for (const Entry& entry : entries)
+    {
+        out << entry.section << ',' << entry.name << ',';
+        if (entry.isString)
+        {
+            std::string value = entry.value;
+            for (size_t pos = value.find('"'); pos != std::string::npos; pos = value.find('"', pos + 2))
+                value.insert(pos, "\"");
+            out << '"' << value << '"';
+        }
+        else
+            out << entry.value;
+        out << '\n';
+    }
+}
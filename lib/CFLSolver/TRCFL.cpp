@@ -14,48 +14,54 @@ void TRCFL::processCFLItem(CFLItem item)
         if (checkAndAddEdge(item.src(), item.dst(), newTy))
             pushIntoWorklist(item.src(), item.dst(), newTy);
 
-    for (auto& iter : cflData()->getSuccs(item.dst()))
+    for (CFGSymbTy rSymb : grammar()->getRightSymbols(item.label().first))
     {
-        Label rty = iter.first;
-        for (Label newTy : binarySumm(item.label(), rty))
+        for (auto& iter : cflData()->getSymbSuccs(item.dst(), rSymb))
         {
-            NodeBS diffDsts;
-            if (grammar()->isTransitive(newTy.first))   // transitive
+            Label rty = iter.first;
+            for (Label newTy : binarySumm(item.label(), rty))
             {
-                diffDsts = computeDiffEdges(item.src(), iter.second, newTy);
-                if (newTy.first == item.label().first && newTy.first == rty.first)      // secondary
-                    // TODO: not push into worklist?
-                    secondaryData.addEdges(item.src(), diffDsts, newTy);
-                else    // primary
-                    cflData()->addEdges(item.src(), diffDsts, newTy);
+                NodeBS diffDsts;
+                if (grammar()->isTransitive(newTy.first))   // transitive
+                {
+                    diffDsts = computeDiffEdges(item.src(), iter.second, newTy);
+                    if (newTy.first == item.label().first && newTy.first == rty.first)      // secondary
+                        // TODO: not push into worklist?
+                        secondaryData->addEdges(item.src(), diffDsts, newTy);
+                    else    // primary
+                        cflData()->addEdges(item.src(), diffDsts, newTy);
+                }
+                else    // non-transitive
+                    diffDsts = checkAndAddEdges(item.src(), iter.second, newTy);
+
+                for (NodeID diffDst : diffDsts)
+                    pushIntoWorklist(item.src(), diffDst, newTy);
             }
-            else    // non-transitive
-                diffDsts = checkAndAddEdges(item.src(), iter.second, newTy);
-
-            for (NodeID diffDst : diffDsts)
-                pushIntoWorklist(item.src(), diffDst, newTy);
         }
     }
 
-    for (auto& iter : cflData()->getPreds(item.src()))
+    for (CFGSymbTy lSymb : grammar()->getLeftSymbols(item.label().first))
     {
-        Label lty = iter.first;
-        for (Label newTy : binarySumm(lty, item.label()))
+        for (auto& iter : cflData()->getSymbPreds(item.src(), lSymb))
         {
-            NodeBS diffSrcs;
-            if (grammar()->isTransitive(newTy.first))   /// transitive
+            Label lty = iter.first;
+            for (Label newTy : binarySumm(lty, item.label()))
             {
-                diffSrcs = computeDiffEdges(iter.second, item.dst(), newTy);
-                if (newTy.first == item.label().first && newTy.first == lty.first)      // secondary
-                    secondaryData.addEdges(diffSrcs, item.dst(), newTy);
-                else
-                    cflData()->addEdges(diffSrcs, item.dst(), newTy);
+                NodeBS diffSrcs;
+                if (grammar()->isTransitive(newTy.first))   /// transitive
+                {
+                    diffSrcs = computeDiffEdges(iter.second, item.dst(), newTy);
+                    if (newTy.first == item.label().first && newTy.first == lty.first)      // secondary
+                        secondaryData->addEdges(diffSrcs, item.dst(), newTy);
+                    else
+                        cflData()->addEdges(diffSrcs, item.dst(), newTy);
+                }
+                else    // non-transitive
+                    diffSrcs = checkAndAddEdges(iter.second, item.dst(), newTy);
+
+                for (NodeID diffSrc : diffSrcs)
+                    pushIntoWorklist(diffSrc, item.dst(), newTy);
             }
-            else    // non-transitive
-                diffSrcs = checkAndAddEdges(iter.second, item.dst(), newTy);
-
-            for (NodeID diffSrc : diffSrcs)
-                pushIntoWorklist(diffSrc, item.dst(), newTy);
         }
     }
 }
@@ -78,7 +84,7 @@ NodeBS TRCFL::computeDiffEdges(NodeID src, const NodeBS& dstSet, Label lbl)
     NodeBS retSet;
     stat->checks += dstSet.count();
     retSet.intersectWithComplement(dstSet, cflData()->getSuccs(src, lbl));
-    retSet.intersectWithComplement(retSet, secondaryData.getSuccs(src, lbl));
+    retSet.intersectWithComplement(retSet, secondaryData->getSuccs(src, lbl));
     return retSet;
 }
 
@@ -91,7 +97,7 @@ NodeBS TRCFL::computeDiffEdges(const NodeBS& srcSet, NodeID dst, Label lbl)
     NodeBS retSet;
     stat->checks += srcSet.count();
     retSet.intersectWithComplement(srcSet, cflData()->getPreds(dst, lbl));
-    retSet.intersectWithComplement(retSet, secondaryData.getPreds(dst, lbl));
+    retSet.intersectWithComplement(retSet, secondaryData->getPreds(dst, lbl));
     return retSet;
 }
 
@@ -100,25 +106,25 @@ void TRCFL::countSumEdges()
 {
     /// calculate summary edges
     stat->numOfSumEdges = 0;
-    for (auto it1 = cflData()->begin(); it1 != cflData()->end(); ++it1)
-        for (auto& it2 : it1->second)
+    for (NodeID src : cflData()->getSuccKeys())
+        for (auto& it2 : cflData()->getSuccs(src))
             stat->numOfSumEdges += it2.second.count();
 
-//    for (auto it1 = secondaryData.begin(); it1 != secondaryData.end(); ++it1)
-//        for (auto& it2 : it1->second)
+//    for (NodeID src : secondaryData->getSuccKeys())
+//        for (auto& it2 : secondaryData->getSuccs(src))
 //            stat->numOfSumEdges += it2.second.count();
 
     /// calculate S edges
     stat->sEdgeSet.clear();
-    for (auto& it1 : cflData()->getSuccMap())
-        for (auto& it2 : it1.second)
+    for (NodeID src : cflData()->getSuccKeys())
+        for (auto& it2 : cflData()->getSuccs(src))
             if (grammar()->isCountSymbol(it2.first.first))
-                stat->sEdgeSet[it1.first] |= it2.second;
+                stat->sEdgeSet[src] |= it2.second;
 
-    for (auto& it1 : secondaryData.getSuccMap())
-        for (auto& it2 : it1.second)
+    for (NodeID src : secondaryData->getSuccKeys())
+        for (auto& it2 : secondaryData->getSuccs(src))
             if (grammar()->isCountSymbol(it2.first.first))
-                stat->sEdgeSet[it1.first] |= it2.second;
+                stat->sEdgeSet[src] |= it2.second;
 
     for (auto& it : stat->sEdgeSet)
         it.second.reset(it.first);
@@ -36,9 +36,10 @@ void FocrVFA::initSolver()
 
 void FocrVFA::solve()
 {
-    while (!isWorklistEmpty())
+    while (!isWorklistEmpty() && !isStopped())
     {
         CFLItem item = popFromWorklist();
+        countItem(item.label());
         addArc(item.src(), item.dst());
     }
 
@@ -101,15 +102,19 @@ void FocrVFA::countSumEdges()
     stat->checks += ecg.checks;
 
     /// calculate summary edges
-    for (auto& it1 : cflData()->getSuccMap())
-        for (auto& it2 : it1.second)
+    for (NodeID src : cflData()->getSuccKeys())
+        for (auto& it2 : cflData()->getSuccs(src))
             if (it2.first.first == call)
             {
                 for (NodeID dst : it2.second)
-                    addCl(it1.first, it2.first.second, ecg.getNode(dst));
+                    addCl(src, it2.first.second, ecg.getNode(dst));
             }
 
     VFAnalysis::countSumEdges();
     stat->numOfSumEdges += ecg.countReachablePairs();
     stat->numOfSEdges += ecg.countReachablePairs();
+
+    if (!CFLOpt::sPairsFName().empty())
+        for (auto& iter : ecg.getReachableMap())
+            stat->sEdgeSet[iter.first] |= iter.second;
 }
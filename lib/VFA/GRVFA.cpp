@@ -9,7 +9,7 @@ using namespace SVF;
 /*!
  *
  */
-Set<Label> GRVFA::binarySumm(Label lty, Label rty)
+LabelSet GRVFA::binarySumm(Label lty, Label rty)
 {
     char lWord = lty.first;
     char rWord = rty.first;
@@ -36,7 +36,7 @@ Set<Label> GRVFA::binarySumm(Label lty, Label rty)
 /*!
  *
  */
-Set<Label> GRVFA::unarySumm(Label lty)
+LabelSet GRVFA::unarySumm(Label lty)
 {
     char lWord = lty.first;
     if (lWord == a)
@@ -49,7 +49,7 @@ Set<Label> GRVFA::unarySumm(Label lty)
 /*!
  *
  */
-Set<Label> GRGspanVFA::binarySumm(Label lty, Label rty)
+LabelSet GRGspanVFA::binarySumm(Label lty, Label rty)
 {
     char lWord = lty.first;
     char rWord = rty.first;
@@ -76,7 +76,7 @@ Set<Label> GRGspanVFA::binarySumm(Label lty, Label rty)
 /*!
  *
  */
-Set<Label> GRGspanVFA::unarySumm(Label lty)
+LabelSet GRGspanVFA::unarySumm(Label lty)
 {
     char lWord = lty.first;
     if (lWord == a)
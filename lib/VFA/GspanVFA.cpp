@@ -3,6 +3,7 @@
 //
 
 #include "VFA/VFAnalysis.h"
+#include <chrono>
 
 using namespace SVF;
 
@@ -38,67 +39,154 @@ void GspanVFA::initSolver()
 void GspanVFA::solve()
 {
     reanalyze = false;
-    CFLData resData;
+    auto start = std::chrono::steady_clock::now();
 
-    for (auto& srcIter: cflData()->getSuccMap())
+    if (numOfThreads > 1)
+        solveInParallel();
+    else
     {
-        NodeID src = srcIter.first;
+        u64_t checks = 0;
+        for (NodeID src: cflData()->getSuccKeys())
+        {
+            if (isStopped())
+                break;
+            CFLData::TypeMap res;
+            summarize(src, res, checks);
+            update(src, res);
+        }
+        stat->checks += checks;
+    }
+
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    stat->roundTimes.push_back(duration.count());
+}
+
+
+/*!
+ * Unlike the sequential rounds, all sources of a round see the old and new edges at the beginning of the round
+ */
+void GspanVFA::solveInParallel()
+{
+    std::vector<NodeID> srcs;
+    for (NodeID src: cflData()->getSuccKeys())
+        srcs.push_back(src);
+
+    /// summarize into thread-local results
+    std::vector<CFLData::TypeMap> results(srcs.size());
+    std::vector<u64_t> checks(numOfThreads, 0);
+    parallelFor(numOfThreads, srcs.size(), [&](u32_t tid, u32_t i)
+    {
+        summarize(srcs[i], results[i], checks[tid]);
+    });
+    for (u64_t threadChecks: checks)
+        stat->checks += threadChecks;
+
+    /// Collect the entries to update, which may create entries and is thus sequential
+    struct MergeItem
+    {
+        NodeBS* oldBS;
+        NodeBS* newBS;
+        NodeBS* resBS;      // nullptr for moving new edges into old ones
+    };
+    std::vector<MergeItem> mergeItems;
+    std::vector<u32_t> offsets;
+    for (u32_t i = 0; i < srcs.size(); ++i)
+    {
+        NodeID src = srcs[i];
+        offsets.push_back(mergeItems.size());
+        for (auto& tyIter: cflData()->getSuccs(src))
+            mergeItems.push_back({&oldData()->getSuccs(src, tyIter.first), &tyIter.second, nullptr});
+        for (auto& tyIter: results[i])
+            mergeItems.push_back({&oldData()->getSuccs(src, tyIter.first), &cflData()->getSuccs(src, tyIter.first),
+                                  &tyIter.second});
+    }
+    offsets.push_back(mergeItems.size());
 
-        // old + new
-        for (auto& tyIter: oldData()->getSuccs(src))
+    /// merge, each source only touches its own entries
+    std::vector<u8_t> changed(numOfThreads, false);
+    parallelFor(numOfThreads, srcs.size(), [&](u32_t tid, u32_t i)
+    {
+        for (u32_t j = offsets[i]; j < offsets[i + 1]; ++j)
         {
-            Label lty = tyIter.first;
-            for (NodeID oldDst1: tyIter.second)
+            MergeItem& item = mergeItems[j];
+            if (!item.resBS)
             {
-                // new
-                for (auto& tyIter2: cflData()->getSuccs(oldDst1))
-                {
-                    for (Label newTy: binarySumm(lty, tyIter2.first))
-                        if (newTy.first && (resData.getSuccs(src, newTy) |= tyIter2.second))
-                            stat->checks += tyIter2.second.count();       // stat
-                }
+                *item.oldBS |= *item.newBS;
+                item.newBS->clear();
+                continue;
             }
+            *item.newBS = std::move(*item.resBS);
+            item.newBS->intersectWithComplement(*item.oldBS);
+            if (!item.newBS->empty())
+                changed[tid] = true;
         }
+    });
+    for (u8_t threadChanged: changed)
+        if (threadChanged)
+            reanalyze = true;
+}
+
 
-        // new + old and new
-        for (auto tyIter: cflData()->getSuccs(src))
+void GspanVFA::summarize(NodeID src, CFLData::TypeMap& res, u64_t& checks)
+{
+    // old + new
+    for (auto& tyIter: oldData()->findSuccs(src))
+    {
+        Label lty = tyIter.first;
+        for (NodeID oldDst1: tyIter.second)
         {
-            Label lty = tyIter.first;
-            for (Label newTy: unarySumm(lty))
-                for (NodeID newDst1: tyIter.second)
+            // new
+            for (auto& tyIter2: cflData()->findSuccs(oldDst1))
+            {
+                for (Label newTy: binarySumm(lty, tyIter2.first))
+                    if (newTy.first && (res[newTy] |= tyIter2.second))
+                        checks += tyIter2.second.count();       // stat
+            }
+        }
+    }
+
+    // new + old and new
+    for (auto& tyIter: cflData()->findSuccs(src))
+    {
+        Label lty = tyIter.first;
+        for (Label newTy: unarySumm(lty))
+            for (NodeID newDst1: tyIter.second)
+            {
+                if (newTy.first && (res[newTy].test_and_set(newDst1)))
+                    checks++;       // stat
+                // old
+                for (auto& tyIter2: oldData()->findSuccs(newDst1))
                 {
-                    if (newTy.first && resData.getSuccs(src, newTy).test_and_set(newDst1))
-                        stat->checks++;       // stat
-                    // old
-                    for (auto& tyIter2: oldData()->getSuccs(newDst1))
-                    {
-                        for (Label newTy: binarySumm(lty, tyIter2.first))
-                            if (newTy.first && (resData.getSuccs(src, newTy) |= tyIter2.second))
-                                stat->checks += tyIter2.second.count();       // stat
-                    }
-                    // new
-                    for (auto& tyIter2: cflData()->getSuccs(newDst1))
-                    {
-                        for (Label newTy: binarySumm(lty, tyIter2.first))
-                            if (newTy.first && (resData.getSuccs(src, newTy) |= tyIter2.second))
-                                stat->checks += tyIter2.second.count();       // stat
-                    }
+                    for (Label newTy: binarySumm(lty, tyIter2.first))
+                        if (newTy.first && (res[newTy] |= tyIter2.second))
+                            checks += tyIter2.second.count();       // stat
                 }
-        }
+                // new
+                for (auto& tyIter2: cflData()->findSuccs(newDst1))
+                {
+                    for (Label newTy: binarySumm(lty, tyIter2.first))
+                        if (newTy.first && (res[newTy] |= tyIter2.second))
+                            checks += tyIter2.second.count();       // stat
+                }
+            }
+    }
+}
 
-        // update old and new
-        for (auto& tyIter: cflData()->getSuccs(src))
-        {
-            oldData()->getSuccs(src, tyIter.first) |= tyIter.second;
-            tyIter.second.clear();
-        }
-        for (auto& tyIter: resData.getSuccs(src))
-        {
-            cflData()->getSuccs(src, tyIter.first) = tyIter.second;
-            cflData()->getSuccs(src, tyIter.first).intersectWithComplement(oldData()->getSuccs(src, tyIter.first));
-            if (!cflData()->getSuccs(src, tyIter.first).empty())
-                reanalyze = true;
-        }
+
+void GspanVFA::update(NodeID src, CFLData::TypeMap& res)
+{
+    // update old and new
+    for (auto& tyIter: cflData()->getSuccs(src))
+    {
+        oldData()->getSuccs(src, tyIter.first) |= tyIter.second;
+        tyIter.second.clear();
+    }
+    for (auto& tyIter: res)
+    {
+        cflData()->getSuccs(src, tyIter.first) = tyIter.second;
+        cflData()->getSuccs(src, tyIter.first).intersectWithComplement(oldData()->getSuccs(src, tyIter.first));
+        if (!cflData()->getSuccs(src, tyIter.first).empty())
+            reanalyze = true;
     }
 }
 
@@ -108,12 +196,17 @@ void GspanVFA::countSumEdges()
     stat->numOfSumEdges = 0;
     std::set<u32_t> s = {A, Cl};
 
-    for (auto iter1 = oldData()->begin(); iter1 != oldData()->end(); ++iter1)
+    stat->sEdgeSet.clear();
+    bool collectsSPairs = !CFLOpt::sPairsFName().empty();
+
+    for (NodeID src: oldData()->getSuccKeys())
     {
-        for (auto& iter2: iter1->second)
+        for (auto& iter2: oldData()->getSuccs(src))
         {
             if (s.find(iter2.first.first) != s.end())
                 stat->numOfSumEdges += iter2.second.count();
+            if (collectsSPairs && iter2.first.first == A)
+                stat->sEdgeSet[src] |= iter2.second;
         }
     }
 }
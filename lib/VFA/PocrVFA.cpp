@@ -35,9 +35,10 @@ void PocrVFA::initSolver()
 
 void PocrVFA::solve()
 {
-    while (!isWorklistEmpty())
+    while (!isWorklistEmpty() && !isStopped())
     {
         CFLItem item = popFromWorklist();
+        countItem(item.label());
         auto& newEdgeMap = hybridData.addArc(item.src(), item.dst());
 
         for (auto& it1 : newEdgeMap)
@@ -81,18 +82,39 @@ void PocrVFA::addCl(NodeID u, u32_t idx, TreeNode* vNode)
 }
 
 
+/*!
+ * A-edges are kept in the trees rather than in the CFL data
+ */
+void PocrVFA::saveState(StateWriter& writer)
+{
+    VFAnalysis::saveState(writer);
+    writer.beginSection(StateWriter::Trees);
+    writer.write((CFGSymbTy) A);
+    writer.write((u32_t) 1);
+    writer.writeTrees(hybridData);
+    writer.endSection();
+}
+
+
+void PocrVFA::setQueryData(QueryServer& server)
+{
+    VFAnalysis::setQueryData(server);
+    server.addTrees(A, &hybridData);
+}
+
+
 void PocrVFA::countSumEdges()
 {
     /// calculate checks
     stat->checks += hybridData.checks;
 
     /// calculate summary edges
-    for (auto& it1 : cflData()->getSuccMap())
-        for (auto& it2 : it1.second)
+    for (NodeID src : cflData()->getSuccKeys())
+        for (auto& it2 : cflData()->getSuccs(src))
             if (it2.first.first == call)
             {
                 for (NodeID dst : it2.second)
-                    addCl(it1.first, it2.first.second, hybridData.getNode(dst, dst));
+                    addCl(src, it2.first.second, hybridData.getNode(dst, dst));
             }
 
     VFAnalysis::countSumEdges();
@@ -102,6 +124,12 @@ void PocrVFA::countSumEdges()
         stat->numOfSumEdges += iter.second.size();
         stat->numOfSEdges += iter.second.size();
     }
+
+    /// indMap[v][u] is the S pair (u, v)
+    if (!CFLOpt::sPairsFName().empty())
+        for (auto& iter1 : hybridData.indMap)
+            for (auto& iter2 : iter1.second)
+                stat->sEdgeSet[iter2.first].set(iter1.first);
 }
 
 
@@ -17,16 +17,34 @@ using namespace SVFUtil;
 
 void VFAnalysis::initialize()
 {
+    double parseStart = VFAStat::getClk();
     setGraph(new IVFG());
     graph()->readGraph(graphName);
 
+    /// states are kept for the input nodes, which simplification changes
+    if (!CFLOpt::loadState().empty() || !CFLOpt::removedEdges().empty())
+    {
+        std::cout << "states are only loaded by the cfl tool or for serving queries (-serve)" << std::endl;
+        exit(UnsupportedExit);
+    }
+    /// queries are answered on the input nodes as well
+    if ((!CFLOpt::saveState().empty() || !CFLOpt::serve().empty())
+        && (getStateKind().empty() || CFLOpt::scc() || CFLOpt::gf() || CFLOpt::graphSimp() || CFLOpt::interDyck()))
+    {
+        std::cout << "solver states and queries are not supported with the given options" << std::endl;
+        exit(UnsupportedExit);
+    }
+
     stat = new VFAStat(this);
     stat->setMemUsageBefore();
+    stat->timeOfParsing = (stat->getClk() - parseStart) / TIMEINTERVAL;
 
     /// Graph simplification
     simplifyGraph();
     /// initialize online solver
+    double initStart = stat->getClk();
     initSolver();
+    stat->timeOfInit = (stat->getClk() - initStart) / TIMEINTERVAL;
 }
 
 
@@ -34,7 +52,16 @@ void VFAnalysis::analyze()
 {
     initialize();
 
-    std::thread th(VFAnalysis::timer);     // timer thread
+    SolveBudget budget(CFLOpt::timeBudget(), CFLOpt::rssBudget());
+    setBudget(&budget);
+    budget.start();
+    ProgressSampler* sampler = nullptr;
+    if (CFLOpt::progress())
+    {
+        sampler = new ProgressSampler(getWordNames(), CFLOpt::progress());
+        setProgress(sampler->getProgress());
+        sampler->start();
+    }
 
     /// Start solving
     double propHorStart = stat->getClk();
@@ -45,16 +72,27 @@ void VFAnalysis::analyze()
         reanalyze = false;
         if (CFLOpt::solveCFL())
             solve();
-    } while (reanalyze);
+    } while (reanalyze && !isStopped());
 
     double propHorEnd = stat->getClk();
     stat->timeOfSolving += (propHorEnd - propHorStart) / TIMEINTERVAL;
 
+    if (sampler)
+    {
+        publishProgress();
+        sampler->stop();
+        setProgress(nullptr);
+        delete sampler;
+    }
+
+    budget.stop();
+    setBudget(nullptr);
+    partial = budget.isExceeded();
+    if (partial)
+        std::cout << "solving stopped as " << budget.getReason() << ", the result is partial" << std::endl;
+
     /// Finalize the analysis
     finalize();
-
-    pthread_cancel(th.native_handle());     // kill timer
-    th.join();
 }
 
 
@@ -65,6 +103,64 @@ void VFAnalysis::finalize()
     dumpStat();
     if (!CFLOpt::outGraphFName().empty())
         graph()->writeGraph(CFLOpt::outGraphFName());
+    if (!CFLOpt::saveState().empty())
+    {
+        StateWriter writer(CFLOpt::saveState(), getStateKind());
+        saveState(writer);
+        if (!writer.good())
+            std::cout << "error writing " << CFLOpt::saveState() << std::endl;
+    }
+}
+
+
+Map<CFGSymbTy, std::string> VFAnalysis::getWordNames()
+{
+    static const char* const wordNames[] = {"a", "call", "ret", "A", "B", "Cl"};
+    Map<CFGSymbTy, std::string> symbols;
+    for (CFGSymbTy word = 0; word < sizeof(wordNames) / sizeof(wordNames[0]); ++word)
+        symbols[word + 1] = wordNames[word];
+    return symbols;
+}
+
+
+/*!
+ * Symbols are named by the words, and the summary edges counted by dumpStat are saved with the others
+ */
+void VFAnalysis::saveState(StateWriter& writer)
+{
+    writer.beginSection(StateWriter::Symbols);
+    writer.writeSymbols(getWordNames());
+    writer.endSection();
+
+    NodeBS nodes;
+    for (auto it = graph()->begin(); it != graph()->end(); ++it)
+        nodes.set(it->first);
+    writer.beginSection(StateWriter::Nodes);
+    writer.writeNodeBS(nodes);
+    writer.endSection();
+
+    writer.beginSection(StateWriter::Data);
+    writer.writeData(*cflData());
+    writer.endSection();
+}
+
+
+void VFAnalysis::setQueryData(QueryServer& server)
+{
+    NodeBS nodes;
+    for (auto it = graph()->begin(); it != graph()->end(); ++it)
+        nodes.set(it->first);
+    server.setData(cflData(), nodes);
+    server.addSymbols(getWordNames());
+    server.setDefaultSymbol("A");
+}
+
+
+void VFAnalysis::serveQueries(const std::string& sockPath)
+{
+    QueryServer server;
+    setQueryData(server);
+    server.serve(sockPath, getNumOfThreads(CFLOpt::serveThreads()));
 }
 
 
@@ -110,20 +206,26 @@ NodeBS VFAnalysis::checkAndAddEdges(const NodeBS& srcSet, NodeID dst, Label lbl)
 void VFAnalysis::countSumEdges()
 {
     stat->numOfSumEdges = 0;
+    stat->sEdgeSet.clear();
+    bool collectsSPairs = !CFLOpt::sPairsFName().empty();
 
-    for (auto iter1 = cflData()->begin(); iter1 != cflData()->end(); ++iter1)
-        for (auto& iter2 : iter1->second)
+    for (NodeID src : cflData()->getSuccKeys())
+        for (auto& iter2 : cflData()->getSuccs(src))
         {
             stat->numOfSumEdges += iter2.second.count();
             if (iter2.first.first == A)
+            {
                 stat->numOfSEdges += iter2.second.count();
+                if (collectsSPairs)
+                    stat->sEdgeSet[src] |= iter2.second;
+            }
         }
 }
 
 
 /// ------------------- Std VFA Methods ----------------------
 
-Set<Label> StdVFA::binarySumm(Label lty, Label rty)
+LabelSet StdVFA::binarySumm(Label lty, Label rty)
 {
     u32_t lWord = lty.first;
     u32_t rWord = rty.first;
@@ -144,7 +246,7 @@ Set<Label> StdVFA::binarySumm(Label lty, Label rty)
 }
 
 
-Set<Label> StdVFA::unarySumm(Label lty)
+LabelSet StdVFA::unarySumm(Label lty)
 {
     u32_t lWord = lty.first;
     if (lWord == a)
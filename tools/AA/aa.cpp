@@ -23,13 +23,33 @@ int main(int argc, char** argv)
     char** arg_vec = new char* [argc];
     std::vector<std::string> moduleNameVec;
     std::vector<std::string> inFileVec;
+    StatSink::setCommandLine(argc, argv);
     processArgs(argc, argv, arg_num, arg_vec, inFileVec);
     OptionBase::parseOptions(arg_num, arg_vec, "Alias analysis\n", "[options] <input>");
 
+    /// answer queries from a saved state without solving
+    if (!CFLOpt::loadState().empty())
+    {
+        QueryServer server;
+        if (CFLOpt::serve().empty())
+        {
+            std::cout << "states are only loaded for serving queries (-serve)" << std::endl;
+            return UnsupportedExit;
+        }
+        if (!server.loadState(CFLOpt::loadState(), "aa-") || !server.setDefaultSymbol("V"))
+        {
+            std::cout << "error loading " << CFLOpt::loadState() << ": not a state of alias analysis" << std::endl;
+            return 1;
+        }
+        server.serve(CFLOpt::serve(), getNumOfThreads(CFLOpt::serveThreads()));
+        return 0;
+    }
+
     AliasAnalysis* aa;
     if (Default_AA())
     {
         aa = new StdAA(inFileVec[0]);
+        aa->setSetMode(CFLOpt::setProp());
         aa->analyze();
     }
     else if (Pocr_AA())
@@ -39,7 +59,10 @@ int main(int argc, char** argv)
     }
     else if (Gspan_AA())
     {
-        aa = new GspanAA(inFileVec[0]);
+        if (CFLOpt::memBudget())
+            aa = new PartGspanAA(inFileVec[0]);
+        else
+            aa = new GspanAA(inFileVec[0]);
         aa->analyze();
     }
     else if (Gr_AA())
@@ -63,5 +86,8 @@ int main(int argc, char** argv)
         aa->analyze();
     }
 
+    if (!CFLOpt::serve().empty())
+        aa->serveQueries(CFLOpt::serve());
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,319 @@
+/*
+ // Benchmark driver of the cfl, aa and vf tools
+ //
+ // Author: Kisslune
+ */
+
+#include "ToolRun.h"
+#include <Util/Options.h>
+#include <algorithm>
+#include <dirent.h>
+#include <fstream>
+#include <iomanip>
+#include <unistd.h>
+
+using namespace SVF;
+
+static Option<std::string> Bin_Dir("bin-dir", "Directory of the cfl, aa and vf tools, that of bench if empty", "");
+static Option<std::string> Input_Dir("input-dir", "Directory of the bundled inputs, benchmarked without -matrix", "tests");
+static Option<std::string> Matrix_File("matrix", "File of the runs, a line of a tool and its inputs each, e.g., 'cfl aa.cfg art.peg'", "");
+static Option<std::string> Solvers("solvers", "Comma-separated solvers, each run by the tools having it", "std,pocr,hpocr,focr,tr,trold,gspan,gr");
+static Option<std::string> Simplify("simplify", "Comma-separated simplifications, each none or scc, gf and interdyck joined by '+'", "none");
+static Option<u32_t> Num_Reps("reps", "Repetitions of each run", 3);
+static Option<u32_t> Run_Budget("run-budget", "Time budget in seconds of each run (0 for the default of the tools)", 0);
+static Option<std::string> Out_File("out", "CSV file of the results", "bench.csv");
+static Option<std::string> Baseline_File("baseline", "CSV file of earlier results, against which regressions are flagged", "");
+static Option<bool> Compare_Only("compare-only", "Compare the results in -out with -baseline without running", false);
+static Option<u32_t> Tolerance("tolerance", "Slowdown or memory growth in percent flagged as a regression", 10);
+static Option<u32_t> Min_Delta("min-delta", "Slowdowns below the specified milliseconds are not flagged", 50);
+
+
+/*!
+ * A run of a tool with a solver and simplifications, repeated -reps times
+ */
+struct BenchRun
+{
+    std::string tool;
+    std::vector<std::string> inputs;
+    std::string solver;
+    std::string simplify;
+
+    std::string getKey() const
+    {
+        std::string key = tool;
+        for (const std::string& input : inputs)
+            key += " " + input;
+        return key + " -" + solver + " " + simplify;
+    }
+};
+
+struct BenchResult
+{
+    std::string status;
+    double wallTime;
+    double solveTime;
+    u64_t peakRss;      // in KB
+    u64_t checks;
+    u64_t sumEdges;
+
+    BenchResult() : wallTime(0), solveTime(0), peakRss(0), checks(0), sumEdges(0)
+    {}
+};
+
+
+static bool hasSolver(const std::string& tool, const std::string& solver)
+{
+    static const Map<std::string, std::vector<std::string>> toolSolvers = {
+            {"cfl", {"std", "pstd", "pocr", "hpocr", "focr", "tr", "trold"}},
+            {"aa",  {"std", "pocr", "focr", "gspan", "gr", "grgspan"}},
+            {"vf",  {"std", "pocr", "focr", "gspan", "gr", "grgspan"}}};
+    auto it = toolSolvers.find(tool);
+    return it != toolSolvers.end() && std::find(it->second.begin(), it->second.end(), solver) != it->second.end();
+}
+
+
+/*!
+ * Without a matrix file, each PEG is run by aa and by cfl with aa.cfg, and each VFG by vf and by cfl with vf.cfg
+ */
+static bool readMatrix(std::vector<std::pair<std::string, std::vector<std::string>>>& matrix)
+{
+    if (!Matrix_File().empty())
+    {
+        std::ifstream in(Matrix_File());
+        if (!in)
+            return false;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            std::vector<std::string> fields = splitList(line, ' ');
+            if (fields.size() < 2 || fields[0][0] == '#')
+                continue;
+            matrix.emplace_back(fields[0], std::vector<std::string>(fields.begin() + 1, fields.end()));
+        }
+        return true;
+    }
+
+    DIR* dir = opendir(Input_Dir().c_str());
+    if (!dir)
+        return false;
+    std::vector<std::string> names;
+    while (struct dirent* entry = readdir(dir))
+        names.push_back(entry->d_name);
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+
+    auto endsWith = [](const std::string& str, const std::string& suffix)
+    { return str.size() > suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0; };
+    for (const std::string& name : names)
+    {
+        std::string path = Input_Dir() + "/" + name;
+        if (endsWith(name, ".peg"))
+        {
+            matrix.emplace_back("aa", std::vector<std::string>{path});
+            matrix.emplace_back("cfl", std::vector<std::string>{Input_Dir() + "/aa.cfg", path});
+        }
+        else if (endsWith(name, ".vfg"))
+        {
+            matrix.emplace_back("vf", std::vector<std::string>{path});
+            matrix.emplace_back("cfl", std::vector<std::string>{Input_Dir() + "/vf.cfg", path});
+        }
+    }
+    return true;
+}
+
+
+/*!
+ * The tool runs with its output discarded, and its peak RSS is taken from the rusage of the child
+ */
+static BenchResult runBench(const std::string& binDir, const BenchRun& run)
+{
+    std::string statFile = Out_File() + ".stat." + std::to_string(getpid());
+    std::vector<std::string> args = {binDir + "/" + run.tool, "-" + run.solver};
+    if (run.simplify != "none")
+        for (const std::string& flag : splitList(run.simplify, '+'))
+            args.push_back("-" + flag);
+    if (Run_Budget())
+        args.push_back("-time-budget=" + std::to_string(Run_Budget()));
+    args.insert(args.end(), run.inputs.begin(), run.inputs.end());
+
+    ToolRun toolRun = runTool(args, statFile);
+    BenchResult res;
+    res.status = toolRun.status;
+    res.wallTime = toolRun.wallTime;
+    res.peakRss = toolRun.peakRss;
+    res.solveTime = toolRun.stats["phases,solve"];
+    res.checks = toolRun.stats["counters,#Checks"];
+    res.sumEdges = toolRun.stats["counters,#SumEdges"];
+    return res;
+}
+
+
+static void writeHeader(std::ostream& out)
+{
+    out << "tool,inputs,solver,simplify,rep,status,wallTime,solveTime,peakRssKB,checks,sumEdges\n";
+}
+
+
+static void writeResult(std::ostream& out, const BenchRun& run, u32_t rep, const BenchResult& res)
+{
+    std::string inputs;
+    for (const std::string& input : run.inputs)
+        inputs += (inputs.empty() ? "" : " ") + input;
+    out << run.tool << ',' << inputs << ',' << run.solver << ',' << run.simplify << ',' << rep << ',' << res.status
+        << ',' << std::setprecision(6) << res.wallTime << ',' << res.solveTime << ',' << res.peakRss << ','
+        << res.checks << ',' << res.sumEdges << '\n';
+}
+
+
+/*!
+ * Results of successful repetitions by the key of their run
+ */
+static bool readResults(const std::string& fname, Map<std::string, std::vector<BenchResult>>& results)
+{
+    std::ifstream in(fname);
+    if (!in)
+        return false;
+    std::string line;
+    std::getline(in, line);
+    while (std::getline(in, line))
+    {
+        std::vector<std::string> fields = splitList(line, ',');
+        if (fields.size() != 11 || fields[5] != "ok")
+            continue;
+        std::string key = fields[0] + " " + fields[1] + " -" + fields[2] + " " + fields[3];
+        BenchResult res;
+        res.status = fields[5];
+        res.wallTime = atof(fields[6].c_str());
+        res.solveTime = atof(fields[7].c_str());
+        res.peakRss = strtoull(fields[8].c_str(), nullptr, 10);
+        res.checks = strtoull(fields[9].c_str(), nullptr, 10);
+        res.sumEdges = strtoull(fields[10].c_str(), nullptr, 10);
+        results[key].push_back(res);
+    }
+    return true;
+}
+
+
+static double median(const std::vector<BenchResult>& results, const std::function<double(const BenchResult&)>& fn)
+{
+    std::vector<double> vals;
+    for (const BenchResult& res : results)
+        vals.push_back(fn(res));
+    std::sort(vals.begin(), vals.end());
+    return vals[vals.size() / 2];
+}
+
+
+/*!
+ * Medians of the repetitions are compared. Slower wall or solving time and larger peak RSS beyond the tolerance
+ * are regressions, and different summary edges are mismatches, i.e., changed results.
+ */
+static u32_t compareResults(const std::string& newFile, const std::string& baseFile)
+{
+    Map<std::string, std::vector<BenchResult>> newResults, baseResults;
+    if (!readResults(newFile, newResults) || !readResults(baseFile, baseResults))
+    {
+        std::cout << "error reading " << newFile << " or " << baseFile << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> keys;
+    for (auto& iter : newResults)
+        if (baseResults.count(iter.first))
+            keys.push_back(iter.first);
+    std::sort(keys.begin(), keys.end());
+
+    double tolerance = Tolerance() / 100.0;
+    double minDelta = Min_Delta() / 1000.0;
+    u32_t numOfFlags = 0;
+    std::cout << std::fixed << std::setprecision(3);
+    for (const std::string& key : keys)
+    {
+        const std::vector<BenchResult>& cur = newResults[key];
+        const std::vector<BenchResult>& base = baseResults[key];
+        auto flagTime = [&](const char* name, const std::function<double(const BenchResult&)>& fn)
+        {
+            double curVal = median(cur, fn), baseVal = median(base, fn);
+            if (curVal > baseVal * (1 + tolerance) && curVal - baseVal >= minDelta)
+            {
+                std::cout << "REGRESSION " << key << ": " << name << " " << baseVal << "s -> " << curVal << "s\n";
+                numOfFlags++;
+            }
+        };
+        flagTime("wallTime", [](const BenchResult& res)
+        { return res.wallTime; });
+        flagTime("solveTime", [](const BenchResult& res)
+        { return res.solveTime; });
+
+        double curRss = median(cur, [](const BenchResult& res)
+        { return (double) res.peakRss; });
+        double baseRss = median(base, [](const BenchResult& res)
+        { return (double) res.peakRss; });
+        if (curRss > baseRss * (1 + tolerance))
+        {
+            std::cout << "REGRESSION " << key << ": peakRss " << baseRss / 1024 << "MB -> " << curRss / 1024 << "MB\n";
+            numOfFlags++;
+        }
+        if (cur[0].sumEdges != base[0].sumEdges)
+        {
+            std::cout << "MISMATCH " << key << ": #SumEdges " << base[0].sumEdges << " -> " << cur[0].sumEdges << "\n";
+            numOfFlags++;
+        }
+    }
+    std::cout << keys.size() << " runs compared, " << numOfFlags << " flagged" << std::endl;
+    return numOfFlags;
+}
+
+
+int main(int argc, char** argv)
+{
+    OptionBase::parseOptions(argc, argv, "Benchmark driver of the cfl, aa and vf tools\n", "[options]");
+
+    if (!Compare_Only())
+    {
+        std::string binDir = Bin_Dir();
+        if (binDir.empty())
+        {
+            std::string self = argv[0];
+            size_t pos = self.rfind('/');
+            binDir = pos == std::string::npos ? "." : self.substr(0, pos);
+        }
+
+        std::vector<std::pair<std::string, std::vector<std::string>>> matrix;
+        if (!readMatrix(matrix))
+        {
+            std::cout << "error reading " << (Matrix_File().empty() ? Input_Dir() : Matrix_File()) << std::endl;
+            return 1;
+        }
+
+        std::vector<BenchRun> runs;
+        for (auto& entry : matrix)
+            for (const std::string& solver : splitList(Solvers(), ','))
+                for (const std::string& simplify : splitList(Simplify(), ','))
+                    if (hasSolver(entry.first, solver))
+                        runs.push_back({entry.first, entry.second, solver, simplify});
+
+        std::ofstream out(Out_File(), std::ios::out | std::ios::trunc);
+        if (!out)
+        {
+            std::cout << "error opening " << Out_File() << std::endl;
+            return 1;
+        }
+        writeHeader(out);
+        for (u32_t i = 0; i < runs.size(); ++i)
+        {
+            for (u32_t rep = 0; rep < Num_Reps(); ++rep)
+            {
+                BenchResult res = runBench(binDir, runs[i]);
+                writeResult(out, runs[i], rep, res);
+                out.flush();
+                std::cout << "[" << i + 1 << "/" << runs.size() << "] " << runs[i].getKey() << " #" << rep << " "
+                          << res.status << " " << res.wallTime << "s" << std::endl;
+            }
+        }
+    }
+
+    if (Baseline_File().empty())
+        return 0;
+    return compareResults(Out_File(), Baseline_File()) ? 1 : 0;
+}
@@ -8,11 +8,14 @@
 using namespace SVF;
 
 static Option<bool> Default_CFL("std", "Standard CFL-reachability analysis", false);
+static Option<bool> PStd_CFL("pstd", "Multi-threaded standard CFL-reachability analysis", false);
 static Option<bool> Pocr_CFL("pocr", "POCR CFL-reachability analysis", false);
 static Option<bool> HPocr_CFL("hpocr", "Hierarchical POCR CFL-reachability analysis", false);
 static Option<bool> Focr_CFL("focr", "Uni-directional CFL-reachability analysis", false);
 static Option<bool> Tr_CFL("trold", "Uni-directional CFL-reachability analysis", false);
 static Option<bool> TrFocr_CFL("tr", "Uni-directional CFL-reachability analysis", false);
+static Option<std::string> Query_Src("query-src", "Derive only count edges from the source nodes listed in the file", "");
+static Option<std::string> Query_Sink("query-sink", "Derive only count edges to the sink nodes listed in the file", "");
 
 
 int main(int argc, char** argv)
@@ -21,14 +24,34 @@ int main(int argc, char** argv)
     char** arg_vec = new char* [argc];
     std::vector<std::string> moduleNameVec;
     std::vector<std::string> inFileVec;
+    StatSink::setCommandLine(argc, argv);
     processArgs(argc, argv, arg_num, arg_vec, inFileVec);
     OptionBase::parseOptions(arg_num, arg_vec, "CFL-reachability analysis\n", "[options] <input>");
 
+    /// a demand-driven solver goes in one direction, from the sources or to the sinks
+    if (!Query_Src().empty() && !Query_Sink().empty())
+    {
+        std::cout << "-query-src and -query-sink cannot be given together" << std::endl;
+        return UnsupportedExit;
+    }
+
     StdCFL* cfl;
 
-    if (Default_CFL())
+    if (!Query_Src().empty() || !Query_Sink().empty())
+    {
+        bool backward = Query_Src().empty();
+        cfl = new DemandCFL(inFileVec[0], inFileVec[1], backward ? Query_Sink() : Query_Src(), backward);
+        cfl->analyze();
+    }
+    else if (Default_CFL())
     {
         cfl = new StdCFL(inFileVec[0], inFileVec[1]);
+        cfl->setSetMode(CFLOpt::setProp());
+        cfl->analyze();
+    }
+    else if (PStd_CFL())
+    {
+        cfl = new ParStdCFL(inFileVec[0], inFileVec[1]);
         cfl->analyze();
     }
     else if (Pocr_CFL())
@@ -59,9 +82,12 @@ int main(int argc, char** argv)
     else
     {
         cfl = new StdCFL(inFileVec[0], inFileVec[1]);
+        cfl->setSetMode(CFLOpt::setProp());
         cfl->analyze();
     }
 
+    if (!CFLOpt::serve().empty())
+        cfl->serveQueries(CFLOpt::serve());
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,85 @@
+//
+// Runs of the cfl, aa and vf tools by the bench and equiv drivers
+//
+
+#include "ToolRun.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+namespace SVF
+{
+/*!
+ * Numbers of the csv statistics of a tool, by section and name, strings are skipped
+ */
+static void readToolStats(const std::string& fname, Map<std::string, double>& stats)
+{
+    std::ifstream in(fname);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        size_t first = line.find(',');
+        size_t second = line.find(',', first + 1);
+        if (first == std::string::npos || second == std::string::npos || line[second + 1] == '"')
+            continue;
+        stats[line.substr(0, second)] = atof(line.c_str() + second + 1);
+    }
+}
+
+
+/*!
+ * The peak RSS is taken from the rusage of the child
+ */
+ToolRun runTool(std::vector<std::string> args, const std::string& statFile)
+{
+    ToolRun run;
+    if (args.empty())
+    {
+        run.status = "failed";
+        return run;
+    }
+    args.insert(args.begin() + 1, {"-stat-format=csv", "-stat-file=" + statFile});
+
+    std::vector<char*> argv;
+    for (std::string& arg : args)
+        argv.push_back(&arg[0]);
+    argv.push_back(nullptr);
+
+    unlink(statFile.c_str());
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        int devNull = ::open("/dev/null", O_WRONLY);
+        dup2(devNull, STDOUT_FILENO);
+        dup2(devNull, STDERR_FILENO);
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage;
+    if (pid < 0 || wait4(pid, &status, 0, &usage) < 0)
+    {
+        run.status = "failed";
+        return run;
+    }
+    run.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    run.peakRss = usage.ru_maxrss;
+
+    readToolStats(statFile, run.stats);
+    unlink(statFile.c_str());
+
+    if (WIFEXITED(status) && WEXITSTATUS(status) == UnsupportedExit)
+        run.status = "unsupported";
+    else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || run.stats.empty())
+        run.status = "failed";
+    else
+        run.status = run.stats.count("counters,Partial") ? "partial" : "ok";
+    return run;
+}
+}
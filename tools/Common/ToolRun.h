@@ -0,0 +1,30 @@
+//
+// Runs of the cfl, aa and vf tools by the bench and equiv drivers
+//
+
+#ifndef POCR_SVF_TOOLRUN_H
+#define POCR_SVF_TOOLRUN_H
+
+#include "CFLData/BasicUtils.h"
+
+namespace SVF
+{
+/*!
+ * A run of a cfl, aa or vf tool
+ */
+struct ToolRun
+{
+    std::string status;     // ok, partial (stopped at a budget), unsupported (refused the options) or failed
+    double wallTime;
+    u64_t peakRss;          // in KB
+    Map<std::string, double> stats;     // csv statistics by "section,name"
+
+    ToolRun() : wallTime(0), peakRss(0)
+    {}
+};
+/// Run args[0] with args in a child with its output discarded, and collect its csv statistics through statFile
+ToolRun runTool(std::vector<std::string> args, const std::string& statFile);
+
+}
+
+#endif //POCR_SVF_TOOLRUN_H
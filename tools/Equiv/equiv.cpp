@@ -0,0 +1,185 @@
+/*
+ // Equivalence checker of two solvers, comparing their S pairs and performance
+ //
+ // Author: Kisslune
+ */
+
+#include "ToolRun.h"
+#include <Util/Options.h>
+#include <fstream>
+#include <iomanip>
+#include <unistd.h>
+
+using namespace SVF;
+
+static Option<std::string> Bin_Dir("bin-dir", "Directory of the cfl, aa and vf tools, that of equiv if empty", "");
+static Option<std::string> Lhs_Cmd("lhs", "The first run, a tool with its options and inputs, e.g., 'aa -pocr tests/art.peg'", "");
+static Option<std::string> Rhs_Cmd("rhs", "The second run, e.g., 'cfl -focr tests/aa.cfg tests/art.peg'", "");
+static Option<std::string> Out_Prefix("out", "Prefix of the S-pair files of the runs, which are kept for inspection", "equiv");
+static Option<u32_t> Max_Diffs("max-diffs", "Number of differing S pairs reported", 10);
+static Option<u32_t> Run_Budget("run-budget", "Time budget in seconds of each run (0 for the default of the tools)", 0);
+
+
+struct RunResult
+{
+    std::string status;
+    std::string spairsFile;
+    double wallTime;
+    double solveTime;
+    u64_t peakRss;      // in KB
+
+    RunResult() : wallTime(0), solveTime(0), peakRss(0)
+    {}
+};
+
+
+/*!
+ * The tool writes its S pairs into <out>.<side>.spairs
+ */
+static RunResult runSide(const std::string& binDir, const std::string& cmd, const std::string& side)
+{
+    RunResult res;
+    res.spairsFile = Out_Prefix() + "." + side + ".spairs";
+    std::string statFile = Out_Prefix() + "." + side + ".stat." + std::to_string(getpid());
+
+    std::vector<std::string> args = splitList(cmd, ' ');
+    if (!args.empty())
+    {
+        args[0] = binDir + "/" + args[0];
+        args.insert(args.begin() + 1, "-write-spairs=" + res.spairsFile);
+        if (Run_Budget())
+            args.insert(args.begin() + 1, "-time-budget=" + std::to_string(Run_Budget()));
+    }
+
+    unlink(res.spairsFile.c_str());
+    ToolRun run = runTool(args, statFile);
+    res.status = run.status;
+    if (res.status == "ok" && access(res.spairsFile.c_str(), R_OK) != 0)
+        res.status = "failed";
+    res.wallTime = run.wallTime;
+    res.peakRss = run.peakRss;
+    res.solveTime = run.stats["phases,solve"];
+    return res;
+}
+
+
+/*!
+ * S-pair files are sorted by src and then dst, as written by the stats, so they are compared by a merge
+ */
+class SPairReader
+{
+public:
+    SPairReader(const std::string& fname) : in(fname), src(0), dst(0), valid(false)
+    {
+        next();
+    }
+
+    inline bool isValid() const
+    { return valid; }
+
+    inline std::pair<NodeID, NodeID> get() const
+    { return std::make_pair(src, dst); }
+
+    void next()
+    {
+        valid = static_cast<bool>(in >> src >> dst);
+    }
+
+private:
+    std::ifstream in;
+    NodeID src;
+    NodeID dst;
+    bool valid;
+};
+
+
+static u64_t compareSPairs(const RunResult& lhs, const RunResult& rhs, u64_t& numOfLhs, u64_t& numOfRhs)
+{
+    SPairReader lReader(lhs.spairsFile), rReader(rhs.spairsFile);
+    u64_t numOfDiffs = 0;
+    numOfLhs = numOfRhs = 0;
+
+    auto report = [&](const char* side, std::pair<NodeID, NodeID> pair)
+    {
+        if (numOfDiffs++ < Max_Diffs())
+            std::cout << "  only in " << side << ": " << pair.first << "\t" << pair.second << "\n";
+    };
+    while (lReader.isValid() || rReader.isValid())
+    {
+        if (!rReader.isValid() || (lReader.isValid() && lReader.get() < rReader.get()))
+        {
+            report("lhs", lReader.get());
+            lReader.next();
+            numOfLhs++;
+        }
+        else if (!lReader.isValid() || rReader.get() < lReader.get())
+        {
+            report("rhs", rReader.get());
+            rReader.next();
+            numOfRhs++;
+        }
+        else
+        {
+            lReader.next();
+            rReader.next();
+            numOfLhs++;
+            numOfRhs++;
+        }
+    }
+    return numOfDiffs;
+}
+
+
+int main(int argc, char** argv)
+{
+    OptionBase::parseOptions(argc, argv, "Equivalence checker of two solvers\n", "[options]");
+
+    if (Lhs_Cmd().empty() || Rhs_Cmd().empty())
+    {
+        std::cout << "usage: equiv -lhs='<TOOL> -<SOLVER> <INPUTS>' -rhs='<TOOL> -<SOLVER> <INPUTS>' [options]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::string binDir = Bin_Dir();
+    if (binDir.empty())
+    {
+        std::string self = argv[0];
+        size_t pos = self.rfind('/');
+        binDir = pos == std::string::npos ? "." : self.substr(0, pos);
+    }
+
+    RunResult lhs = runSide(binDir, Lhs_Cmd(), "lhs");
+    RunResult rhs = runSide(binDir, Rhs_Cmd(), "rhs");
+    if (lhs.status != "ok" || rhs.status != "ok")
+    {
+        std::cout << "lhs " << lhs.status << ", rhs " << rhs.status << ", the S pairs are not compared" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Comparing S pairs of\n  lhs: " << Lhs_Cmd() << "\n  rhs: " << Rhs_Cmd() << "\n";
+    u64_t numOfLhs = 0, numOfRhs = 0;
+    u64_t numOfDiffs = compareSPairs(lhs, rhs, numOfLhs, numOfRhs);
+    if (numOfDiffs > Max_Diffs())
+        std::cout << "  ... " << numOfDiffs - Max_Diffs() << " more\n";
+
+    auto ratio = [](double lVal, double rVal)
+    { return lVal > 0 ? rVal / lVal : 0; };
+    const int field_width = 14;
+    std::cout.flags(std::ios::left);
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << std::setw(field_width) << "" << std::setw(field_width) << "lhs" << std::setw(field_width) << "rhs"
+              << "rhs/lhs\n";
+    std::cout << std::setw(field_width) << "#SPairs" << std::setw(field_width) << numOfLhs
+              << std::setw(field_width) << numOfRhs << ratio(numOfLhs, numOfRhs) << "\n";
+    std::cout << std::setw(field_width) << "WallTime(s)" << std::setw(field_width) << lhs.wallTime
+              << std::setw(field_width) << rhs.wallTime << ratio(lhs.wallTime, rhs.wallTime) << "\n";
+    std::cout << std::setw(field_width) << "SolveTime(s)" << std::setw(field_width) << lhs.solveTime
+              << std::setw(field_width) << rhs.solveTime << ratio(lhs.solveTime, rhs.solveTime) << "\n";
+    std::cout << std::setw(field_width) << "PeakRss(MB)" << std::setw(field_width) << lhs.peakRss / 1024.0
+              << std::setw(field_width) << rhs.peakRss / 1024.0 << ratio(lhs.peakRss, rhs.peakRss) << "\n";
+
+    std::cout << (numOfDiffs ? "MISMATCH, " + std::to_string(numOfDiffs) + " S pairs differ" : "EQUIVALENT")
+              << std::endl;
+    return numOfDiffs ? 1 : 0;
+}
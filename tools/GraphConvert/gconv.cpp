@@ -0,0 +1,26 @@
+/*
+ // Conversion between text and binary graph files
+ //
+ // Author: Kisslune
+ */
+
+#include "CFLData/BinGraph.h"
+
+using namespace SVF;
+
+
+int main(int argc, char** argv)
+{
+    bool toText = argc == 4 && std::string(argv[1]) == "-to-text";
+    if (argc != 3 && !toText)
+    {
+        std::cout << "Usage: gconv [-to-text] <input> <output>\n"
+                  << "  converts a tab-separated .peg/.vfg/.cfl graph into a binary graph file,\n"
+                  << "  or a binary graph file back into text with -to-text\n";
+        return 1;
+    }
+
+    if (toText)
+        return BinGraph::writeText(argv[2], argv[3]) ? 0 : 1;
+    return BinGraph::convert(argv[1], argv[2]) ? 0 : 1;
+}
@@ -0,0 +1,267 @@
+/*
+ // Generator of synthetic PEGs and VFGs for scaling studies
+ //
+ // Author: Kisslune
+ */
+
+#include <Util/Options.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+
+using namespace SVF;
+
+static Option<std::string> Graph_Kind("kind", "Kind of the generated graph: peg or vfg", "peg");
+static Option<std::string> Out_File("out", "The file the graph is written into", "");
+static Option<u32_t> Num_Nodes("nodes", "Number of nodes", 1000);
+static Option<u32_t> Degree("degree", "Average out-degree of nodes", 4);
+static Option<std::string> Degree_Dist("dist", "Distribution of out-degrees and edge ends: uniform or powerlaw", "uniform");
+static Option<u32_t> Deref_Ratio("deref", "Percentage of PEG edges labelled d", 30);
+static Option<u32_t> Field_Ratio("field", "Percentage of PEG edges labelled f_i", 10);
+static Option<u32_t> Num_Fields("fields", "Number of field indices of f_i edges", 4);
+static Option<bool> Write_Reverse("reverse", "Also write the reverse edges (abar, dbar and fbar_i) of a PEG", true);
+static Option<u32_t> Num_Funcs("funcs", "Number of functions of a VFG (0 for one per 100 nodes)", 0);
+static Option<u32_t> Num_Callsites("callsites", "Number of call sites of a VFG (0 for two per function)", 0);
+static Option<u32_t> Call_Depth("depth", "Number of levels of the call graph of a VFG", 8);
+static Option<u32_t> Recursion_Ratio("recursion", "Percentage of call sites calling a function of the same or an upper level", 5);
+static Option<u32_t> Src_Ratio("srcs", "Percentage of VFG nodes marked as sources", 0);
+static Option<u32_t> Scc_Size("scc", "Size of the assignment cycles (0 for no cycles)", 0);
+static Option<u32_t> Scc_Ratio("scc-ratio", "Percentage of nodes in assignment cycles", 10);
+static Option<u32_t> Rand_Seed("seed", "Seed of the generator, the same seed and options give the same graph", 1);
+
+
+/*!
+ * Edges are written as they are generated, so that memory does not grow with the number of edges.
+ * Random numbers are derived from the raw engine output only, as the standard distributions differ across
+ * library implementations.
+ */
+class GraphWriter
+{
+public:
+    GraphWriter(std::ofstream& out, u64_t seed) : out(out), rng(seed), numOfEdges(0)
+    {}
+
+    inline u32_t randInt(u32_t bound)
+    {
+        return bound ? rng() % bound : 0;
+    }
+
+    /// uniform in (0, 1]
+    inline double randUnit()
+    {
+        return ((rng() >> 11) + 1) * 0x1.0p-53;
+    }
+
+    inline bool chance(u32_t percent)
+    {
+        return randInt(100) < percent;
+    }
+
+    /// Pareto distribution with shape 2, whose mean is `mean`
+    inline u32_t powerLaw(u32_t mean, u32_t cap)
+    {
+        double val = mean / 2.0 / std::sqrt(randUnit());
+        return (u32_t) std::min(val, (double) cap);
+    }
+
+    /// An out-degree with the given mean
+    u32_t outDegree(u32_t mean, u32_t cap)
+    {
+        if (Degree_Dist() == "powerlaw")
+            return powerLaw(mean, cap);
+        return std::min(randInt(2 * mean + 1), cap);
+    }
+
+    /// An edge end in [base, base + range), skewed to small offsets (hubs) for power-law graphs
+    NodeID edgeEnd(NodeID base, u32_t range)
+    {
+        if (Degree_Dist() == "powerlaw")
+            return base + std::min((u32_t) (range * randUnit() * randUnit()), range - 1);
+        return base + randInt(range);
+    }
+
+    void write(NodeID src, NodeID dst, const char* lbl)
+    {
+        out << src << '\t' << dst << '\t' << lbl << '\n';
+        numOfEdges++;
+    }
+
+    void write(NodeID src, NodeID dst, const char* lbl, u32_t idx)
+    {
+        out << src << '\t' << dst << '\t' << lbl << '\t' << idx << '\n';
+        numOfEdges++;
+    }
+
+    inline u64_t getNumOfEdges() const
+    {
+        return numOfEdges;
+    }
+
+private:
+    std::ofstream& out;
+    std::mt19937_64 rng;
+    u64_t numOfEdges;
+};
+
+
+/*!
+ * Cycles of `scc` nodes over the first scc-ratio percent of [base, base + range)
+ */
+static void writeCycles(GraphWriter& gw, NodeID base, u32_t range, bool reverse)
+{
+    if (Scc_Size() < 2)
+        return;
+    u32_t inCycles = (u64_t) range * std::min(Scc_Ratio(), 100U) / 100;
+    for (u32_t start = 0; start + Scc_Size() <= inCycles; start += Scc_Size())
+    {
+        for (u32_t i = 0; i < Scc_Size(); ++i)
+        {
+            NodeID src = base + start + i;
+            NodeID dst = base + start + (i + 1) % Scc_Size();
+            gw.write(src, dst, "a");
+            if (reverse)
+                gw.write(dst, src, "abar");
+        }
+    }
+}
+
+
+/*!
+ * PEG edges are a, d and f_i, each written with its reverse edge like the bundled PEGs
+ */
+static void generatePEG(GraphWriter& gw)
+{
+    u32_t n = Num_Nodes();
+    bool reverse = Write_Reverse();
+    writeCycles(gw, 0, n, reverse);
+
+    u32_t derefRatio = std::min(Deref_Ratio(), 100U);
+    u32_t fieldRatio = std::min(Field_Ratio(), 100 - derefRatio);
+    for (NodeID src = 0; src < n; ++src)
+    {
+        u32_t deg = gw.outDegree(Degree(), n - 1);
+        for (u32_t i = 0; i < deg; ++i)
+        {
+            NodeID dst = gw.edgeEnd(0, n);
+            if (dst == src)
+                continue;
+            u32_t kind = gw.randInt(100);
+            if (kind < derefRatio)
+            {
+                gw.write(src, dst, "d");
+                if (reverse)
+                    gw.write(dst, src, "dbar");
+            }
+            else if (kind < derefRatio + fieldRatio)
+            {
+                u32_t idx = gw.randInt(std::max(Num_Fields(), 1U));
+                gw.write(src, dst, "f_i", idx);
+                if (reverse)
+                    gw.write(dst, src, "fbar_i", idx);
+            }
+            else
+            {
+                gw.write(src, dst, "a");
+                if (reverse)
+                    gw.write(dst, src, "abar");
+            }
+        }
+    }
+}
+
+
+/*!
+ * A VFG is made of functions of consecutive nodes connected by a edges, and call sites connecting an actual
+ * parameter of the caller to a formal parameter of the callee (call_i) and a formal return of the callee to the
+ * actual return of the caller (ret_i), with the call site as the index.
+ * Functions are assigned to `depth` levels, callees are on the next level, except for recursive call sites.
+ */
+static void generateVFG(GraphWriter& gw)
+{
+    u32_t n = Num_Nodes();
+    u32_t funcs = Num_Funcs() ? Num_Funcs() : std::max(n / 100, 1U);
+    funcs = std::min(funcs, n);
+    u32_t funcSize = n / funcs;
+    u32_t levels = std::min(std::max(Call_Depth(), 1U), funcs);
+    u32_t perLevel = funcs / levels;
+
+    /// intraprocedural flows
+    for (u32_t func = 0; func < funcs; ++func)
+    {
+        NodeID base = func * funcSize;
+        u32_t size = func + 1 == funcs ? n - base : funcSize;
+        writeCycles(gw, base, size, false);
+        for (NodeID src = base; src < base + size; ++src)
+        {
+            u32_t deg = gw.outDegree(Degree(), size - 1);
+            for (u32_t i = 0; i < deg; ++i)
+            {
+                NodeID dst = gw.edgeEnd(base, size);
+                if (dst != src)
+                    gw.write(src, dst, "a");
+            }
+        }
+    }
+
+    /// interprocedural flows, the levels of callers and callees are picked first
+    u32_t callsites = Num_Callsites() ? Num_Callsites() : 2 * funcs;
+    for (u32_t cs = 1; cs <= callsites; ++cs)
+    {
+        u32_t callerLevel = gw.randInt(std::max(levels - 1, 1U));
+        u32_t calleeLevel = callerLevel + 1;
+        if (calleeLevel == levels || gw.chance(Recursion_Ratio()))
+            calleeLevel = gw.randInt(callerLevel + 1);
+        u32_t caller = std::min(callerLevel * perLevel + gw.randInt(perLevel), funcs - 1);
+        u32_t callee = std::min(calleeLevel * perLevel + gw.randInt(perLevel), funcs - 1);
+
+        NodeID callerBase = caller * funcSize, calleeBase = callee * funcSize;
+        u32_t callerSize = caller + 1 == funcs ? n - callerBase : funcSize;
+        u32_t calleeSize = callee + 1 == funcs ? n - calleeBase : funcSize;
+        /// formal parameters and returns are the first and last nodes of a function
+        u32_t params = 1 + gw.randInt(3);
+        for (u32_t i = 0; i < params; ++i)
+            gw.write(callerBase + gw.randInt(callerSize), calleeBase + i % calleeSize, "call_i", cs);
+        gw.write(calleeBase + calleeSize - 1, callerBase + gw.randInt(callerSize), "ret_i", cs);
+    }
+
+    for (NodeID id = 0; id < n && Src_Ratio(); ++id)
+        if (gw.chance(Src_Ratio()))
+            gw.write(id, id, "src");
+}
+
+
+int main(int argc, char** argv)
+{
+    OptionBase::parseOptions(argc, argv, "Generator of synthetic PEGs and VFGs\n", "[options]");
+
+    if (Out_File().empty() || (Graph_Kind() != "peg" && Graph_Kind() != "vfg") || Num_Nodes() < 2 ||
+        (Degree_Dist() != "uniform" && Degree_Dist() != "powerlaw"))
+    {
+        std::cout << "usage: ggen -kind=<peg|vfg> -out=<FILE> [-nodes=N] [-dist=<uniform|powerlaw>] [options]"
+                  << std::endl;
+        return 1;
+    }
+
+    /// the buffer is set before opening to take effect
+    std::vector<char> buffer(1 << 20);
+    std::ofstream out;
+    out.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    out.open(Out_File(), std::ios::out | std::ios::trunc);
+    if (!out)
+    {
+        std::cout << "error opening " << Out_File() << std::endl;
+        return 1;
+    }
+
+    GraphWriter gw(out, Rand_Seed());
+    if (Graph_Kind() == "peg")
+        generatePEG(gw);
+    else
+        generateVFG(gw);
+    out.close();
+
+    std::cout << "wrote " << gw.getNumOfEdges() << " edges over " << Num_Nodes() << " nodes into "
+              << Out_File() << std::endl;
+    return 0;
+}
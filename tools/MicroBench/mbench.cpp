@@ -0,0 +1,257 @@
+/*
+ // Microbenchmarks of the data structures of CFL solvers
+ //
+ // Author: Kisslune
+ */
+
+#include "CFLData/ECG.h"
+#include <Util/Options.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <random>
+
+using namespace SVF;
+
+static Option<std::string> Structures("structures", "Comma-separated structures: cfldata, flatdata, hybrid, ecg and bsecg", "cfldata,flatdata,hybrid,ecg,bsecg");
+static Option<std::string> Workloads("workloads", "Comma-separated workloads: dag, chain, cycle and powerlaw", "dag,chain,cycle,powerlaw");
+static Option<std::string> Densities("densities", "Comma-separated percentages of the ID range taken by nodes", "100,10");
+static Option<u32_t> Num_Nodes("nodes", "Number of nodes of a workload", 2000);
+static Option<u32_t> Degree("degree", "Average out-degree of the dag and powerlaw workloads", 4);
+static Option<u32_t> Num_Labels("labels", "Number of labels of the edges inserted into CFL data", 4);
+static Option<u32_t> Num_Reps("reps", "Repetitions of each benchmark, whose median is reported", 5);
+static Option<u32_t> Rand_Seed("seed", "Seed of the random workloads", 1);
+static Option<std::string> Out_File("out", "Also write the results into the specified CSV file", "");
+
+
+typedef std::vector<std::pair<NodeID, NodeID>> EdgeList;
+
+/*!
+ * A workload is a list of edges over node IDs, inserted in order
+ */
+struct Workload
+{
+    std::vector<NodeID> nodes;
+    EdgeList edges;
+};
+
+
+/*!
+ * Nodes 0..n-1 are mapped to IDs spread over n * 100 / density, in random order, so that the IDs of a sparse
+ * workload fall into separate bit vector elements
+ */
+static Workload makeWorkload(const std::string& kind, u32_t density, std::mt19937& rng)
+{
+    u32_t n = std::max(Num_Nodes(), 2U);
+    u32_t range = (u64_t) n * 100 / std::max(density, 1U);
+    std::vector<NodeID> ids(range);
+    for (u32_t i = 0; i < range; ++i)
+        ids[i] = i;
+    std::shuffle(ids.begin(), ids.end(), rng);
+    ids.resize(n);
+    std::sort(ids.begin(), ids.end());
+
+    Workload wl;
+    wl.nodes = ids;
+    std::uniform_int_distribution<u32_t> nodeDist(0, n - 1);
+    if (kind == "chain" || kind == "cycle")
+    {
+        for (u32_t i = 0; i + 1 < n; ++i)
+            wl.edges.emplace_back(i, i + 1);
+        if (kind == "cycle")
+            wl.edges.emplace_back(n - 1, 0);
+    }
+    else if (kind == "dag")
+    {
+        /// edges go from smaller to larger nodes
+        for (u64_t i = 0; i < (u64_t) n * Degree(); ++i)
+        {
+            u32_t u = nodeDist(rng), v = nodeDist(rng);
+            if (u != v)
+                wl.edges.emplace_back(std::min(u, v), std::max(u, v));
+        }
+    }
+    else if (kind == "powerlaw")
+    {
+        /// preferential attachment: an end of a new edge is an end of an earlier edge half of the time
+        std::vector<u32_t> ends;
+        for (u64_t i = 0; i < (u64_t) n * Degree(); ++i)
+        {
+            u32_t u = nodeDist(rng);
+            u32_t v = ends.empty() || rng() % 2 ? nodeDist(rng) : ends[rng() % ends.size()];
+            if (u == v)
+                continue;
+            wl.edges.emplace_back(u, v);
+            ends.push_back(u);
+            ends.push_back(v);
+        }
+    }
+
+    for (auto& edge : wl.edges)
+        edge = std::make_pair(ids[edge.first], ids[edge.second]);
+    return wl;
+}
+
+
+/*!
+ * Each benchmark returns the number of new edges (or reachable pairs), which is the same across repetitions
+ */
+static u64_t benchCFLData(CFLData& data, const Workload& wl)
+{
+    u64_t newEdges = 0;
+    for (u32_t i = 0; i < wl.edges.size(); ++i)
+        newEdges += data.checkAndAddEdge(wl.edges[i].first, wl.edges[i].second, Label(i % Num_Labels() + 1, 0));
+
+    /// bulk insertion of the successors of each node as those of its successors
+    for (auto& edge : wl.edges)
+        for (u32_t lbl = 1; lbl <= Num_Labels(); ++lbl)
+        {
+            NodeBS dsts = data.getSuccs(edge.second, Label(lbl, 0));
+            newEdges += data.checkAndAddEdges(edge.first, dsts, Label(lbl, 0)).count();
+        }
+    return newEdges;
+}
+
+
+static u64_t benchHybrid(const Workload& wl)
+{
+    HybridData trees;
+    for (NodeID id : wl.nodes)
+        trees.addInd(id, id);
+
+    u64_t newEdges = 0;
+    for (auto& edge : wl.edges)
+        for (auto& iter : trees.addArc(edge.first, edge.second))
+            newEdges += iter.second.count();
+    return newEdges;
+}
+
+
+/*!
+ * Edges are inserted as the focr solvers do: skipped if already reachable, and inserted as back edges if closing
+ * a cycle
+ */
+static u64_t benchECG(const Workload& wl)
+{
+    ECG ecg;
+    for (NodeID id : wl.nodes)
+        ecg.addNode(id);
+
+    for (auto& edge : wl.edges)
+    {
+        if (ecg.isReachable(edge.first, edge.second))
+            continue;
+        if (ecg.isReachable(edge.second, edge.first))
+            ecg.insertBackEdge(edge.first, edge.second);
+        else
+            ecg.insertForwardEdge(edge.first, edge.second);
+    }
+
+    u64_t pairs = 0;
+    for (auto& iter : ecg.getReachableMap())
+        pairs += iter.second.count();
+    for (auto& iter : ecg.getNodes())
+        delete iter.second;
+    return pairs;
+}
+
+
+static u64_t benchBSECG(const Workload& wl)
+{
+    BSECG ecg;
+    for (NodeID id : wl.nodes)
+        ecg.addNode(id);
+
+    for (auto& edge : wl.edges)
+    {
+        if (ecg.isReachable(edge.first, edge.second))
+            continue;
+        if (ecg.isReachable(edge.second, edge.first))
+            ecg.insertBackEdge(edge.first, edge.second);
+        else
+            ecg.insertForthEdge(edge.first, edge.second);
+    }
+
+    u64_t pairs = 0;
+    for (auto& iter : ecg.getReachableMap())
+        pairs += iter.second.count();
+    return pairs;
+}
+
+
+static u64_t runBench(const std::string& structure, const Workload& wl)
+{
+    if (structure == "cfldata")
+    {
+        CFLData data;
+        return benchCFLData(data, wl);
+    }
+    if (structure == "flatdata")
+    {
+        FlatCFLData data;
+        return benchCFLData(data, wl);
+    }
+    if (structure == "hybrid")
+        return benchHybrid(wl);
+    if (structure == "ecg")
+        return benchECG(wl);
+    return benchBSECG(wl);
+}
+
+
+int main(int argc, char** argv)
+{
+    OptionBase::parseOptions(argc, argv, "Microbenchmarks of the data structures of CFL solvers\n", "[options]");
+
+    std::ofstream csv;
+    if (!Out_File().empty())
+    {
+        csv.open(Out_File(), std::ios::out | std::ios::trunc);
+        if (!csv)
+        {
+            std::cout << "error opening " << Out_File() << std::endl;
+            return 1;
+        }
+        csv << "structure,workload,density,nodes,edges,result,medianMs,edgesPerSec\n";
+    }
+
+    const int field_width = 12;
+    std::cout.flags(std::ios::left);
+    std::cout << std::setw(field_width) << "Structure" << std::setw(field_width) << "Workload"
+              << std::setw(field_width) << "Density" << std::setw(field_width) << "Edges"
+              << std::setw(field_width) << "Result" << std::setw(field_width) << "Median(ms)" << "Edges/s\n";
+
+    for (const std::string& kind : splitList(Workloads(), ','))
+    {
+        for (const std::string& densityStr : splitList(Densities(), ','))
+        {
+            u32_t density = std::stoul(densityStr);
+            std::mt19937 rng(Rand_Seed());
+            Workload wl = makeWorkload(kind, density, rng);
+
+            for (const std::string& structure : splitList(Structures(), ','))
+            {
+                std::vector<double> times;
+                u64_t result = 0;
+                for (u32_t rep = 0; rep < std::max(Num_Reps(), 1U); ++rep)
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    result = runBench(structure, wl);
+                    times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+                }
+                std::sort(times.begin(), times.end());
+                double median = times[times.size() / 2];
+                double rate = median > 0 ? wl.edges.size() / (median / 1000) : 0;
+
+                std::cout << std::setw(field_width) << structure << std::setw(field_width) << kind
+                          << std::setw(field_width) << density << std::setw(field_width) << wl.edges.size()
+                          << std::setw(field_width) << result << std::setw(field_width) << median << rate << std::endl;
+                if (csv.is_open())
+                    csv << structure << ',' << kind << ',' << density << ',' << wl.nodes.size() << ','
+                        << wl.edges.size() << ',' << result << ',' << median << ',' << rate << '\n';
+            }
+        }
+    }
+    return 0;
+}
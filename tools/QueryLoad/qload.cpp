@@ -0,0 +1,133 @@
+/*
+ // Load generator of the query server (-serve)
+ //
+ // Author: Kisslune
+ */
+
+#include "CFLSolver/QueryServer.h"
+#include <Util/Options.h>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <thread>
+
+using namespace SVF;
+
+static Option<std::string> Sock_Path("socket", "Unix socket of the query server", "");
+static Option<u32_t> Num_Clients("clients", "Number of concurrent client connections", 4);
+static Option<u32_t> Num_Requests("requests", "Number of requests of each client", 1000);
+static Option<u32_t> Batch_Size("batch", "Number of queries in a request", 64);
+static Option<bool> Row_Query("rows", "Ask row queries instead of point queries", false);
+static Option<std::string> Query_Symbol("query-symbol", "Symbol to query, the default symbol of the server if empty", "");
+static Option<u32_t> Rand_Seed("seed", "Seed of the random queries", 1);
+static Option<bool> Stop_Server("stop", "Shut the server down after the run", false);
+
+
+/*!
+ * Queries are drawn uniformly from the node IDs of the server, and the latency is measured per request
+ */
+static bool runClient(u32_t clientId, std::vector<double>& latencies, u64_t& numOfAnswers)
+{
+    QueryClient client;
+    CFGSymbTy symb;
+    NodeID numOfNodes;
+    if (!client.connect(Sock_Path()) || !client.info(symb, numOfNodes)
+        || (!Query_Symbol().empty() && !client.lookupSymbol(Query_Symbol(), symb)))
+        return false;
+
+    std::mt19937 rng(Rand_Seed() + clientId);
+    std::uniform_int_distribution<NodeID> nodeDist(0, numOfNodes ? numOfNodes - 1 : 0);
+    std::vector<std::pair<NodeID, NodeID>> pairs(Batch_Size());
+    std::vector<NodeID> srcs(Batch_Size());
+    std::vector<u8_t> results;
+    std::vector<std::vector<NodeID>> rows;
+
+    for (u32_t i = 0; i < Num_Requests(); ++i)
+    {
+        for (u32_t j = 0; j < Batch_Size(); ++j)
+        {
+            pairs[j] = std::make_pair(nodeDist(rng), nodeDist(rng));
+            srcs[j] = pairs[j].first;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool ok = Row_Query() ? client.queryRows(symb, srcs, rows) : client.queryPoints(symb, pairs, results);
+        auto end = std::chrono::steady_clock::now();
+        if (!ok)
+            return false;
+        latencies.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+
+        if (Row_Query())
+            for (auto& row : rows)
+                numOfAnswers += row.size();
+        else
+            for (u8_t res : results)
+                numOfAnswers += res;
+    }
+    return true;
+}
+
+
+int main(int argc, char** argv)
+{
+    OptionBase::parseOptions(argc, argv, "Load generator of the query server\n", "[options]");
+    if (Sock_Path().empty())
+    {
+        std::cout << "no socket given (-socket)" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::vector<double>> latencies(Num_Clients());
+    std::vector<u64_t> numOfAnswers(Num_Clients(), 0);
+    std::vector<u8_t> succeeded(Num_Clients(), 0);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (u32_t i = 0; i < Num_Clients(); ++i)
+        threads.emplace_back([&, i]()
+                             { succeeded[i] = runClient(i, latencies[i], numOfAnswers[i]); });
+    for (std::thread& th : threads)
+        th.join();
+    double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> allLatencies;
+    u64_t totalAnswers = 0;
+    for (u32_t i = 0; i < Num_Clients(); ++i)
+    {
+        if (!succeeded[i])
+            std::cout << "client " << i << " failed" << std::endl;
+        allLatencies.insert(allLatencies.end(), latencies[i].begin(), latencies[i].end());
+        totalAnswers += numOfAnswers[i];
+    }
+    std::sort(allLatencies.begin(), allLatencies.end());
+    auto percentile = [&allLatencies](double p)
+    {
+        if (allLatencies.empty())
+            return 0.0;
+        return allLatencies[std::min<size_t>(allLatencies.size() - 1, allLatencies.size() * p)];
+    };
+    u64_t numOfQueries = (u64_t) allLatencies.size() * Batch_Size();
+
+    const int field_width = 20;
+    std::cout.flags(std::ios::left);
+    std::cout << std::setw(field_width) << "Clients" << Num_Clients() << "\n";
+    std::cout << std::setw(field_width) << "Requests" << allLatencies.size() << "\n";
+    std::cout << std::setw(field_width) << "Queries" << numOfQueries << "\n";
+    std::cout << std::setw(field_width) << (Row_Query() ? "RowEdges" : "Positives") << totalAnswers << "\n";
+    std::cout << std::setw(field_width) << "WallTime" << wallTime << "\n";
+    std::cout << std::setw(field_width) << "QueriesPerSec" << (wallTime > 0 ? numOfQueries / wallTime : 0) << "\n";
+    std::cout << std::setw(field_width) << "LatencyP50(us)" << percentile(0.5) << "\n";
+    std::cout << std::setw(field_width) << "LatencyP99(us)" << percentile(0.99) << "\n";
+
+    if (Stop_Server())
+    {
+        QueryClient client;
+        if (!client.connect(Sock_Path()) || !client.shutdown())
+            std::cout << "error shutting the server down" << std::endl;
+    }
+
+    for (u8_t ok : succeeded)
+        if (!ok)
+            return 1;
+    return 0;
+}
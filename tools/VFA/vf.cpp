@@ -23,13 +23,33 @@ int main(int argc, char** argv)
     char** arg_vec = new char* [argc];
     std::vector<std::string> moduleNameVec;
     std::vector<std::string> inFileVec;
+    StatSink::setCommandLine(argc, argv);
     processArgs(argc, argv, arg_num, arg_vec, inFileVec);
     OptionBase::parseOptions(arg_num, arg_vec, "Valueflow analysis\n", "[options] <input>");
 
+    /// answer queries from a saved state without solving
+    if (!CFLOpt::loadState().empty())
+    {
+        QueryServer server;
+        if (CFLOpt::serve().empty())
+        {
+            std::cout << "states are only loaded for serving queries (-serve)" << std::endl;
+            return UnsupportedExit;
+        }
+        if (!server.loadState(CFLOpt::loadState(), "vfa-") || !server.setDefaultSymbol("A"))
+        {
+            std::cout << "error loading " << CFLOpt::loadState() << ": not a state of valueflow analysis" << std::endl;
+            return 1;
+        }
+        server.serve(CFLOpt::serve(), getNumOfThreads(CFLOpt::serveThreads()));
+        return 0;
+    }
+
     VFAnalysis* vfa;
     if (Default_VFA())
     {
         vfa = new StdVFA(inFileVec[0]);
+        vfa->setSetMode(CFLOpt::setProp());
         vfa->analyze();
     }
     else if (Pocr_VFA())
@@ -63,5 +83,8 @@ int main(int argc, char** argv)
         vfa->analyze();
     }
 
+    if (!CFLOpt::serve().empty())
+        vfa->serveQueries(CFLOpt::serve());
+
     return 0;
 }
\ No newline at end of file